@@ -0,0 +1,271 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    macro.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+// Macro benchmarks rendering each preset with canned MIDI
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../zynayumi/zynayumi.hpp"
+#include "../zynayumi/programs.hpp"
+#include "../zynayumi/registerstream.hpp"
+#include "../test/clip.hpp"
+
+using namespace zynayumi;
+
+// Render the canned clip with a preset, a sample rate and a
+// precision as arguments. Report the time per sample (in second with
+// SI prefix, n for ns) and the realtime factor, i.e. the number of
+// seconds of audio rendered per second.
+static void BM_Preset(benchmark::State& state)
+{
+	unsigned preset = state.range(0);
+	int sample_rate = state.range(1);
+
+	Zynayumi zynayumi;
+	load_preset(zynayumi, preset, sample_rate);
+	zynayumi.engine.precision = (Precision)state.range(2);
+	state.SetLabel(zynayumi.patch.name);
+
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_size = CLIP_DURATION * sample_rate;
+	std::vector<float> left(clip_size), right(clip_size);
+
+	for (auto _ : state) {
+		render_clip(zynayumi, clip, clip_size, left.data(), right.data());
+		benchmark::ClobberMemory();
+	}
+
+	double samples = (double)clip_size * state.iterations();
+	state.counters["time/sample"] =
+		benchmark::Counter(samples, benchmark::Counter::kIsRate
+		                   | benchmark::Counter::kInvert);
+	state.counters["realtime"] =
+		benchmark::Counter(samples / sample_rate, benchmark::Counter::kIsRate);
+
+	// Ratio of the register writes that changed a value and were
+	// forwarded to ayumi
+	double writes = 0.0, changes = 0.0;
+	for (int r = 0; r < (int)Chip::Register::Count; r++) {
+		writes += zynayumi.engine.chips[0].get_write_count((Chip::Register)r);
+		changes += zynayumi.engine.chips[0].get_change_count((Chip::Register)r);
+	}
+	state.counters["forwarded"] = changes / writes;
+}
+BENCHMARK(BM_Preset)
+->Apply([](benchmark::internal::Benchmark* b) {
+	        for (unsigned p = 0; p < Programs::count; p++)
+		        for (int sr : {44100, 48000, 96000})
+			        for (Precision pr : {Precision::Double, Precision::Single})
+				        b->Args({p, sr, (int)pr});
+        })
+->Unit(benchmark::kMillisecond);
+
+// Render silence with a preset, given as argument, once the canned
+// clip is over, as an idle instance does. Report the time per sample
+// and the ratio of host blocks reported silent.
+static void BM_Idle(benchmark::State& state)
+{
+	const int sample_rate = 44100;
+	unsigned preset = state.range(0);
+
+	Zynayumi zynayumi;
+	load_preset(zynayumi, preset, sample_rate);
+	state.SetLabel(zynayumi.patch.name);
+
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_size = CLIP_DURATION * sample_rate;
+	std::vector<float> left(clip_size), right(clip_size);
+	render_clip(zynayumi, clip, clip_size, left.data(), right.data());
+
+	double blocks = 0.0, silent_blocks = 0.0;
+	for (auto _ : state) {
+		for (unsigned long f = 0; f < clip_size; f += CLIP_BLOCK_SIZE) {
+			unsigned long size = std::min(CLIP_BLOCK_SIZE, clip_size - f);
+			silent_blocks += zynayumi.audio_process(&left[f], &right[f], size);
+			blocks++;
+		}
+		benchmark::ClobberMemory();
+	}
+
+	double samples = (double)clip_size * state.iterations();
+	state.counters["time/sample"] =
+		benchmark::Counter(samples, benchmark::Counter::kIsRate
+		                   | benchmark::Counter::kInvert);
+	state.counters["silent"] = silent_blocks / blocks;
+}
+BENCHMARK(BM_Idle)
+->DenseRange(0, Programs::count - 1)
+->Unit(benchmark::kMillisecond);
+
+// Null test of the single precision path against the double precision
+// one, see precision_null_test. Render the canned clip with a preset,
+// given as argument, in both precisions, then report the maximum
+// absolute difference and the signal to difference ratio in dB. The
+// test itself, failing below NULL_TEST_MIN_SNR, is run by ctest.
+static void BM_PrecisionNullTest(benchmark::State& state)
+{
+	const int sample_rate = 44100;
+	unsigned preset = state.range(0);
+	double max_diff = 0.0, snr = 0.0;
+	for (auto _ : state)
+		snr = precision_null_test(preset, sample_rate, max_diff);
+	state.SetLabel(Programs::get_patch(preset).name);
+	state.counters["max_diff"] = max_diff;
+	state.counters["snr_dB"] = snr;
+}
+BENCHMARK(BM_PrecisionNullTest)
+->DenseRange(0, Programs::count - 1)
+->Iterations(1)
+->Unit(benchmark::kMillisecond);
+
+// Play back the register stream of the canned clip rendered with a
+// preset, given as argument, captured at 50 Hz. Report the same
+// counters as BM_Preset, to compare playback with synthesis.
+static void BM_RegisterPlayback(benchmark::State& state)
+{
+	const int sample_rate = 44100;
+	unsigned preset = state.range(0);
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_size = CLIP_DURATION * sample_rate;
+	std::vector<float> left(clip_size), right(clip_size);
+
+	// Capture the stream
+	const std::string path = std::string(P_tmpdir) + "/zynayumi_bench.zrs";
+	{
+		Zynayumi zynayumi;
+		load_preset(zynayumi, preset, sample_rate);
+		RegisterCapture capture;
+		capture.open(path);
+		zynayumi.engine.register_capture = &capture;
+		render_clip(zynayumi, clip, clip_size, left.data(), right.data());
+		if (not capture.close()) {
+			state.SkipWithError("Cannot write the register stream");
+			return;
+		}
+	}
+	RegisterStream stream;
+	bool opened = stream.open(path);
+	std::remove(path.c_str());
+	if (not opened) {
+		state.SkipWithError("Cannot map the register stream");
+		return;
+	}
+
+	Zynayumi zynayumi;
+	load_preset(zynayumi, preset, sample_rate);
+	state.SetLabel(zynayumi.patch.name);
+	RegisterPlayer player(stream);
+	zynayumi.engine.register_player = &player;
+
+	for (auto _ : state) {
+		player.rewind();
+		render_clip(zynayumi, {}, clip_size, left.data(), right.data());
+		benchmark::ClobberMemory();
+	}
+
+	double samples = (double)clip_size * state.iterations();
+	state.counters["time/sample"] =
+		benchmark::Counter(samples, benchmark::Counter::kIsRate
+		                   | benchmark::Counter::kInvert);
+	state.counters["realtime"] =
+		benchmark::Counter(samples / sample_rate, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_RegisterPlayback)
+->DenseRange(0, Programs::count - 1)
+->Unit(benchmark::kMillisecond);
+
+// Render the canned clip with the first preset by large host blocks,
+// while the gain is automated by a square wave, with the smoothing
+// mode given as argument. Report the time per sample and the largest
+// gain step between two samples, measured against a render with a
+// constant gain, to compare zipper noise across smoothing modes.
+static void BM_GainAutomation(benchmark::State& state)
+{
+	const int sample_rate = 44100;
+	const unsigned long block_size = 4096;
+	const unsigned long automation_period = 512;
+	const float low_gain = 0.25f;
+	SmoothingMode mode = (SmoothingMode)state.range(0);
+	state.SetLabel(to_string(mode));
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_size = CLIP_DURATION * sample_rate;
+
+	// Reference render with a constant gain
+	std::vector<float> ref_left(clip_size), ref_right(clip_size);
+	{
+		Zynayumi zynayumi;
+		load_preset(zynayumi, 0, sample_rate);
+		render_clip(zynayumi, clip, clip_size, ref_left.data(),
+		            ref_right.data(), block_size);
+	}
+
+	std::vector<float> left(clip_size), right(clip_size);
+	for (auto _ : state) {
+		state.PauseTiming();
+		Zynayumi zynayumi;
+		Parameters parameters(zynayumi, zynayumi.patch);
+		load_preset(zynayumi, 0, sample_rate);
+		zynayumi.engine.smoothing_mode = mode;
+		auto automate = [&](unsigned long f, unsigned long size) {
+			for (unsigned long i = 0; i < size; i++)
+				if ((f + i) % automation_period == 0) {
+					bool low = (f + i) / automation_period % 2;
+					parameters.post_value(GAIN, low ? low_gain : 1.0f, i);
+				}
+		};
+		state.ResumeTiming();
+		render_clip(zynayumi, clip, clip_size, left.data(), right.data(),
+		            block_size, automate);
+		benchmark::ClobberMemory();
+	}
+
+	// Largest step of the gain, recovered where the reference is loud
+	// enough
+	double max_step = 0.0, previous_gain = -1.0;
+	for (unsigned long n = 0; n < clip_size; n++) {
+		if (std::abs(ref_left[n]) < 1e-2f) {
+			previous_gain = -1.0;
+			continue;
+		}
+		double gain = left[n] / ref_left[n];
+		if (0.0 <= previous_gain)
+			max_step = std::max(max_step, std::abs(gain - previous_gain));
+		previous_gain = gain;
+	}
+
+	double samples = (double)clip_size * state.iterations();
+	state.counters["time/sample"] =
+		benchmark::Counter(samples, benchmark::Counter::kIsRate
+		                   | benchmark::Counter::kInvert);
+	state.counters["gain step"] = max_step;
+}
+BENCHMARK(BM_GainAutomation)
+->DenseRange(0, (int)SmoothingMode::Count - 1)
+->Unit(benchmark::kMillisecond);
@@ -0,0 +1,251 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    micro.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+// Micro benchmarks of the engine building blocks
+
+#include <benchmark/benchmark.h>
+
+#include "../zynayumi/zynayumi.hpp"
+#include "../zynayumi/parameters.hpp"
+
+using namespace zynayumi;
+
+// Update a single voice holding a note, with the control period
+// given as argument.
+static void BM_VoiceUpdate(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	zynayumi.engine.control_period = state.range(0);
+	zynayumi.patch.lfo.depth = 1.0;
+	Voice voice(zynayumi.engine, zynayumi.patch, zynayumi.engine.chips[0], 0);
+	voice.set_note_on(60, 100);
+	// Process a frame so that the smoothed parameters follow the patch
+	float left, right;
+	zynayumi.engine.audio_process(&left, &right, 1);
+	for (auto _ : state)
+		voice.update(0);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VoiceUpdate)->Arg(1)->Arg(16);
+
+// Process one step of ayumi with all three channels playing a tone
+static void BM_AyumiProcess(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	ayumi& ay = zynayumi.engine.chips[0].ay;
+	for (int ch = 0; ch < 3; ch++) {
+		ayumi_set_tone(&ay, ch, 200 + 50 * ch);
+		ayumi_set_mixer(&ay, ch, false, true, false);
+		ayumi_set_volume(&ay, ch, 15);
+	}
+	for (auto _ : state) {
+		ayumi_process(&ay);
+		benchmark::DoNotOptimize(ay.left);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AyumiProcess);
+
+// Convert pitches into tone periods, with legacy tuning as argument
+static void BM_Pitch2TonePeriod(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	zynayumi.patch.tone.legacy_tuning = state.range(0);
+	double pitch = 0.0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(zynayumi.engine.pitch2toneperiod(pitch));
+		pitch = pitch < 127.0 ? pitch + 0.01 : 0.0;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Pitch2TonePeriod)->Arg(0)->Arg(1);
+
+static void BM_Pitch2EnvPeriod(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	double pitch = 0.0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(zynayumi.engine.pitch2envperiod(pitch));
+		pitch = pitch < 127.0 ? pitch + 0.01 : 0.0;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Pitch2EnvPeriod);
+
+// Note on followed by note off, with the cantus mode as argument
+static void BM_NoteOnOff(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	zynayumi.patch.cantusmode = (CantusMode)state.range(0);
+	unsigned char pitch = 0;
+	for (auto _ : state) {
+		zynayumi.note_on_process(0, pitch, 100);
+		zynayumi.note_off_process(0, pitch);
+		pitch = (pitch + 1) % 128;
+	}
+	state.SetItemsProcessed(2 * state.iterations());
+}
+BENCHMARK(BM_NoteOnOff)
+->Arg((int)CantusMode::Mono)
+->Arg((int)CantusMode::Poly)
+->Arg((int)CantusMode::Unison);
+
+// Note on and off of a 4 note chord while arpeggiating
+static void BM_ChordArp(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	zynayumi.patch.playmode = PlayMode::UpArp;
+	const unsigned char chord[] = {60, 64, 67, 71};
+	for (auto _ : state) {
+		for (unsigned char pitch : chord)
+			zynayumi.note_on_process(0, pitch, 100);
+		for (unsigned char pitch : chord)
+			zynayumi.note_off_process(0, pitch);
+	}
+	state.SetItemsProcessed(8 * state.iterations());
+}
+BENCHMARK(BM_ChordArp);
+
+static void BM_PitchWheel(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	short value = 0;
+	for (auto _ : state) {
+		zynayumi.pitch_wheel_process(0, value);
+		value = (value + 1) % 16384;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PitchWheel);
+
+// Raw MIDI control change, going through the status dispatch
+static void BM_ControlChange(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	unsigned char data[3] = {0xb0, 1, 0};
+	for (auto _ : state) {
+		zynayumi.raw_event_process(3, data);
+		data[2] = (data[2] + 1) % 128;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ControlChange);
+
+// Query the metadata and value of every parameter, as a host
+// refreshing its user interface does
+static void BM_ParameterPoll(benchmark::State& state)
+{
+	Zynayumi zynayumi;
+	Parameters parameters(zynayumi, zynayumi.patch);
+	for (auto _ : state) {
+		for (int i = 0; i < PARAMETERS_COUNT; i++) {
+			ParameterIndex pi = (ParameterIndex)i;
+			const ParameterDescriptor& d = Parameters::get_descriptor(pi);
+			benchmark::DoNotOptimize(d.symbol);
+			benchmark::DoNotOptimize(parameters.is_int(pi));
+			benchmark::DoNotOptimize(parameters.is_enum(pi));
+			benchmark::DoNotOptimize(parameters.is_percent(pi));
+			benchmark::DoNotOptimize(parameters.norm_float_value(pi));
+		}
+	}
+	state.SetItemsProcessed(PARAMETERS_COUNT * state.iterations());
+}
+BENCHMARK(BM_ParameterPoll);
+
+// Decimate a block of samples of type T, with the decimation factor
+// and the kernel as arguments.
+template<typename T>
+static void BM_DecimatorBlock(benchmark::State& state)
+{
+	const int block = DecimatorBase::MAX_BLOCK_SIZE;
+	const int factor = state.range(0);
+	Decimator<T> decimator;
+	decimator.set_kernel((DecimatorBase::Kernel)state.range(1));
+	decimator.configure(factor);
+	if ((int)decimator.get_kernel() != state.range(1)) {
+		state.SkipWithError("Kernel not supported by the CPU");
+		return;
+	}
+	T left_in[block * DecimatorBase::MAX_FACTOR];
+	T right_in[block * DecimatorBase::MAX_FACTOR];
+	for (int i = 0; i < block * factor; i++) {
+		left_in[i] = (i % 7) / T(7);
+		right_in[i] = (i % 5) / T(5);
+	}
+	T left_out[block], right_out[block];
+	for (auto _ : state) {
+		decimator.process_block(left_in, right_in, block, left_out, right_out);
+		benchmark::DoNotOptimize(left_out);
+		benchmark::DoNotOptimize(right_out);
+	}
+	state.SetItemsProcessed(block * state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_DecimatorBlock, double)
+->ArgsProduct({{2, 4}, {(int)DecimatorBase::Kernel::Scalar,
+                        (int)DecimatorBase::Kernel::SSE2,
+                        (int)DecimatorBase::Kernel::AVX2}});
+BENCHMARK_TEMPLATE(BM_DecimatorBlock, float)
+->ArgsProduct({{2, 4}, {(int)DecimatorBase::Kernel::Scalar,
+                        (int)DecimatorBase::Kernel::SSE2,
+                        (int)DecimatorBase::Kernel::AVX2}});
+
+// Render a held note, with oversampling and control period as
+// arguments.
+static void BM_AudioProcess(benchmark::State& state)
+{
+	const unsigned long block = 256;
+	Zynayumi zynayumi;
+	zynayumi.engine.oversampling = state.range(0);
+	zynayumi.engine.control_period = state.range(1);
+	zynayumi.note_on_process(0, 60, 100);
+	float left[block], right[block];
+	for (auto _ : state) {
+		zynayumi.audio_process(left, right, block);
+		benchmark::DoNotOptimize(left);
+	}
+	state.SetItemsProcessed(block * state.iterations());
+}
+BENCHMARK(BM_AudioProcess)->ArgsProduct({{1, 2, 4}, {1, 16}});
+
+// Render a pad holding three notes per chip in poly mode, with the
+// number of chips and the number of worker threads as arguments.
+static void BM_PolyChips(benchmark::State& state)
+{
+	const unsigned long block = 256;
+	Zynayumi zynayumi;
+	zynayumi.patch.cantusmode = CantusMode::Poly;
+	zynayumi.engine.chip_count = state.range(0);
+	zynayumi.set_worker_count(state.range(1));
+	float left[block], right[block];
+	zynayumi.audio_process(left, right, block);
+	for (int n = 0; n < 3 * state.range(0); n++)
+		zynayumi.note_on_process(0, 48 + 2 * n, 100);
+	for (auto _ : state) {
+		zynayumi.audio_process(left, right, block);
+		benchmark::DoNotOptimize(left);
+	}
+	state.SetItemsProcessed(block * state.iterations());
+}
+BENCHMARK(BM_PolyChips)->ArgsProduct({{1, 2, 4, 8}, {0, 1, 3}})->UseRealTime();
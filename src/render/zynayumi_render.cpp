@@ -0,0 +1,297 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    zynayumi_render.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+// Command line tool rendering Standard MIDI Files to WAV files with a
+// preset, or with every preset, rendering several files concurrently.
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../zynayumi/zynayumi.hpp"
+#include "../zynayumi/midifile.hpp"
+#include "../zynayumi/offline.hpp"
+#include "../zynayumi/parameters.hpp"
+#include "../zynayumi/programs.hpp"
+#include "../zynayumi/registerstream.hpp"
+
+using namespace zynayumi;
+
+namespace {
+
+// Default oversampling and number of chips
+int oversampling_dflt()
+{
+	return Parameters::get_descriptor(OVERSAMPLING).dflt;
+}
+
+int chip_count_dflt()
+{
+	return Parameters::get_descriptor(CHIP_COUNT).dflt;
+}
+
+void usage(const char* name)
+{
+	std::printf("Usage: %s [options] INPUT.mid OUTPUT.wav [INPUT.mid OUTPUT.wav ...]\n"
+	            "       %s [options] -b DIRECTORY INPUT.mid\n"
+	            "\n"
+	            "Render Standard MIDI Files to WAV files, or with -b, render\n"
+	            "INPUT.mid with every preset into DIRECTORY. Inputs with the\n"
+	            ".zrs extension are register streams, played back instead.\n"
+	            "\n"
+	            "Options:\n"
+	            "  -p PROGRAM   Preset index [default=0]\n"
+	            "  -b DIRECTORY Render every preset into DIRECTORY\n"
+	            "  -l           List presets and exit\n"
+	            "  -r RATE      Sample rate [default=44100]\n"
+	            "  -f FORMAT    Sample format, int16 or float [default=int16]\n"
+	            "  -o FACTOR    Oversampling, from 1 to 4 [default=%d]\n"
+	            "  -c COUNT     Number of chips, from 1 to %d [default=%d]\n"
+	            "  -t TAIL      Time rendered after the last event, in second [default=2]\n"
+	            "  -y RATE      Also capture the registers at RATE frames per second,\n"
+	            "               50 or 60 for instance, into OUTPUT.zrs\n"
+	            "  -j THREADS   Number of renders run concurrently [default=all cores]\n"
+	            "  -h           Print this help\n",
+	            name, name, oversampling_dflt(), Engine::MAX_CHIPS,
+	            chip_count_dflt());
+}
+
+// Return the file name of the render of preset program in bank mode
+std::string bank_file_name(unsigned program, const std::string& name)
+{
+	char prefix[16];
+	std::snprintf(prefix, sizeof(prefix), "%02u_", program);
+	std::string file_name = prefix + name;
+	for (char& c : file_name)
+		if (not std::isalnum((unsigned char)c) and c != '_' and c != '-')
+			c = '_';
+	return file_name + ".wav";
+}
+
+// Return the path of the register stream captured along output
+std::string register_stream_path(const std::string& output)
+{
+	size_t dot = output.rfind('.');
+	size_t slash = output.rfind('/');
+	if (dot == std::string::npos or (slash != std::string::npos and dot < slash))
+		dot = output.size();
+	return output.substr(0, dot) + ".zrs";
+}
+
+} // ~namespace
+
+int main(int argc, char* argv[])
+{
+	unsigned program = 0;
+	int sample_rate = 44100;
+	SampleFormat format = SampleFormat::Int16;
+	int oversampling = oversampling_dflt();
+	int chip_count = chip_count_dflt();
+	double tail = 2.0;
+	int thread_count = 0;
+	std::string bank_directory;
+	double frame_rate = 0.0;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "p:b:lr:f:o:c:t:y:j:h")) != -1) {
+		switch (opt) {
+		case 'p':
+			program = std::atoi(optarg);
+			break;
+		case 'b':
+			bank_directory = optarg;
+			break;
+		case 'l': {
+			Zynayumi zynayumi;
+			Programs programs(zynayumi);
+			for (unsigned i = 0; i < Programs::count; i++)
+				std::printf("%u: %s\n", i, programs.patches[i].name.c_str());
+			return EXIT_SUCCESS;
+		}
+		case 'r':
+			sample_rate = std::atoi(optarg);
+			break;
+		case 'f':
+			if (std::string(optarg) == "float")
+				format = SampleFormat::Float32;
+			else if (std::string(optarg) == "int16")
+				format = SampleFormat::Int16;
+			else {
+				std::fprintf(stderr, "Unknown sample format %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'o':
+			oversampling = std::atoi(optarg);
+			break;
+		case 'c':
+			chip_count = std::atoi(optarg);
+			break;
+		case 't':
+			tail = std::atof(optarg);
+			break;
+		case 'y':
+			frame_rate = std::atof(optarg);
+			if (frame_rate <= 0.0) {
+				std::fprintf(stderr, "Invalid frame rate %s\n", optarg);
+				return EXIT_FAILURE;
+			}
+			break;
+		case 'j':
+			thread_count = std::atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			return EXIT_SUCCESS;
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (sample_rate <= 0) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// Preset, input and output of each render
+	struct Render {
+		unsigned program;
+		std::string input;
+		std::string output;
+	};
+	std::vector<Render> renders;
+	int file_count = argc - optind;
+	if (bank_directory.empty()) {
+		if (file_count == 0 or file_count % 2 != 0) {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (Programs::count <= program) {
+			std::fprintf(stderr, "No preset %u\n", program);
+			return EXIT_FAILURE;
+		}
+		for (int i = optind; i < argc; i += 2)
+			renders.push_back({program, argv[i], argv[i + 1]});
+	} else {
+		if (file_count != 1) {
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		for (unsigned i = 0; i < Programs::count; i++) {
+			std::string name = bank_file_name(i, Programs::get_patch(i).name);
+			renders.push_back({i, argv[optind], bank_directory + "/" + name});
+		}
+	}
+
+	// Parse the MIDI files, load the presets and open the WAV files
+	std::vector<OfflineJob> jobs(renders.size());
+	std::vector<std::unique_ptr<WavWriter>> writers;
+	std::vector<std::unique_ptr<RegisterCapture>> captures;
+	std::vector<std::unique_ptr<RegisterStream>> streams;
+	for (unsigned i = 0; i < jobs.size(); i++) {
+		const Render& render = renders[i];
+		OfflineJob& job = jobs[i];
+		double duration = 0.0;
+		if (register_stream_path(render.input) == render.input) {
+			streams.emplace_back(new RegisterStream());
+			if (not streams.back()->open(render.input)) {
+				std::fprintf(stderr, "Cannot load register stream %s\n",
+				             render.input.c_str());
+				return EXIT_FAILURE;
+			}
+			job.register_stream = streams.back().get();
+			duration = job.register_stream->get_frame_count()
+				/ job.register_stream->get_frame_rate();
+		} else {
+			MidiFile midi_file;
+			if (not midi_file.load(render.input)) {
+				std::fprintf(stderr, "Cannot load MIDI file %s\n",
+				             render.input.c_str());
+				return EXIT_FAILURE;
+			}
+			job.events = midi_file.to_midi_events(sample_rate);
+			duration = midi_file.get_duration();
+		}
+		writers.emplace_back(new WavWriter(format));
+		if (not writers.back()->open(render.output, sample_rate)) {
+			std::fprintf(stderr, "Cannot create WAV file %s\n",
+			             render.output.c_str());
+			return EXIT_FAILURE;
+		}
+		job.patch = Programs::get_patch(render.program);
+		job.frame_count = (duration + tail) * sample_rate;
+		job.sample_rate = sample_rate;
+		job.oversampling = oversampling;
+		job.chip_count = chip_count;
+		job.sink = writers.back().get();
+		if (0.0 < frame_rate) {
+			std::string path = register_stream_path(render.output);
+			captures.emplace_back(new RegisterCapture());
+			if (not captures.back()->open(path, frame_rate)) {
+				std::fprintf(stderr, "Cannot create register stream %s\n",
+				             path.c_str());
+				return EXIT_FAILURE;
+			}
+			job.register_capture = captures.back().get();
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	render_offline(jobs, thread_count);
+	double elapsed = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	// Finalize the WAV files and report the timing of each render
+	int status = EXIT_SUCCESS;
+	double duration = 0.0;
+	std::printf("%-40s %9s %9s %9s %6s\n",
+	            "Output", "Audio (s)", "Time (s)", "Realtime", "Thread");
+	for (unsigned i = 0; i < jobs.size(); i++) {
+		const OfflineJob& job = jobs[i];
+		const std::string& output = renders[i].output;
+		if (not writers[i]->close() or not job.success) {
+			std::fprintf(stderr, "Failed to write WAV file %s\n", output.c_str());
+			status = EXIT_FAILURE;
+		}
+		if (job.register_capture and not job.register_capture->close()) {
+			std::fprintf(stderr, "Failed to write register stream %s\n",
+			             register_stream_path(output).c_str());
+			status = EXIT_FAILURE;
+		}
+		double job_duration = (double)job.frame_count / sample_rate;
+		duration += job_duration;
+		std::printf("%-40s %9.2f %9.3f %8.1fx %6d\n", output.c_str(),
+		            job_duration, job.render_time, job.realtime_factor(),
+		            job.thread);
+	}
+	std::printf("Rendered %.1f seconds of audio in %.2f seconds (%.1fx realtime)\n",
+	            duration, elapsed, duration / elapsed);
+	return status;
+}
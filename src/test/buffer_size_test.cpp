@@ -0,0 +1,78 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    buffer_size_test.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+// Render the same clip with every preset by host blocks of two
+// different sizes, the clip being played twice with a silence in
+// between, long enough for the engine to skip rendering. Fail unless
+// the renders are identical, as the output must not depend on the
+// host block size.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "clip.hpp"
+#include "../zynayumi/programs.hpp"
+
+using namespace zynayumi;
+
+int main()
+{
+	const int sample_rate = 44100;
+	const unsigned long block_sizes[] = {CLIP_BLOCK_SIZE, 100};
+	const double replay_time = 2.0 * CLIP_DURATION;
+
+	// Play the canned clip, then again after a silence
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_count = clip.size();
+	for (unsigned long i = 0; i < clip_count; i++) {
+		ClipEvent event = clip[i];
+		event.frame += replay_time * sample_rate;
+		clip.push_back(event);
+	}
+	unsigned long clip_size = (replay_time + CLIP_DURATION) * sample_rate;
+
+	int status = EXIT_SUCCESS;
+	for (unsigned preset = 0; preset < Programs::count; preset++) {
+		std::vector<float> out[2][2];
+		for (int b = 0; b < 2; b++) {
+			Zynayumi zynayumi;
+			load_preset(zynayumi, preset, sample_rate);
+			out[b][0].resize(clip_size);
+			out[b][1].resize(clip_size);
+			render_clip(zynayumi, clip, clip_size,
+			            out[b][0].data(), out[b][1].data(), block_sizes[b]);
+		}
+		unsigned long diff_count = 0;
+		for (int c = 0; c < 2; c++)
+			for (unsigned long i = 0; i < clip_size; i++)
+				diff_count += out[0][c][i] != out[1][c][i];
+		bool pass = diff_count == 0;
+		std::printf("%-30s differing samples=%lu %s\n",
+		            Programs::get_patch(preset).name.c_str(),
+		            diff_count, pass ? "pass" : "FAIL");
+		if (not pass)
+			status = EXIT_FAILURE;
+	}
+	return status;
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    clip.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include "clip.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../zynayumi/parameters.hpp"
+#include "../zynayumi/programs.hpp"
+
+namespace zynayumi {
+
+std::vector<ClipEvent> canned_clip(int sample_rate)
+{
+	std::vector<ClipEvent> clip;
+	auto at = [&](double time, unsigned char status,
+	              unsigned char pitch, unsigned char velocity) {
+		clip.push_back({(unsigned long)(time * sample_rate),
+		                {status, pitch, velocity}});
+	};
+	const unsigned char bass[] = {36, 36, 48, 36, 39, 41, 43, 46};
+	for (unsigned i = 0; i < 8; i++) {
+		at(0.125 * i, 0x90, bass[i], 100);
+		at(0.125 * i + 0.1, 0x80, bass[i], 0);
+	}
+	const unsigned char chord[] = {60, 63, 67};
+	for (unsigned char pitch : chord)
+		at(1.0, 0x90, pitch, 90);
+	for (unsigned char pitch : chord)
+		at(1.9, 0x80, pitch, 0);
+	return clip;
+}
+
+void load_preset(Zynayumi& zynayumi, unsigned preset, int sample_rate)
+{
+	Parameters parameters(zynayumi, zynayumi.patch);
+	Programs programs(zynayumi);
+	parameters = *programs.parameters_pts[preset];
+	parameters.update();
+	zynayumi.set_sample_rate(sample_rate);
+}
+
+void render_clip(Zynayumi& zynayumi, const std::vector<ClipEvent>& clip,
+                 unsigned long clip_size, float* left, float* right,
+                 unsigned long block_size,
+                 const std::function<void(unsigned long, unsigned long)>& automate)
+{
+	std::vector<MidiEvent> events(block_size);
+	auto ev = clip.begin();
+	for (unsigned long f = 0; f < clip_size; f += block_size) {
+		unsigned long size = std::min(block_size, clip_size - f);
+		if (automate)
+			automate(f, size);
+
+		// Gather the events of that block
+		unsigned count = 0;
+		for (; ev != clip.end() and ev->frame < f + size; ++ev) {
+			MidiEvent& me = events[count++];
+			me.frame = ev->frame - f;
+			me.size = 3;
+			std::copy(ev->data, ev->data + 3, me.data);
+		}
+
+		zynayumi.audio_process(left + f, right + f, size, events.data(), count);
+	}
+}
+
+double precision_null_test(unsigned preset, int sample_rate, double& max_diff)
+{
+	std::vector<ClipEvent> clip = canned_clip(sample_rate);
+	unsigned long clip_size = CLIP_DURATION * sample_rate;
+	std::vector<float> out[(int)Precision::Count][2];
+	for (Precision pr : {Precision::Double, Precision::Single}) {
+		Zynayumi zynayumi;
+		load_preset(zynayumi, preset, sample_rate);
+		zynayumi.engine.precision = pr;
+		std::vector<float>* o = out[(int)pr];
+		o[0].resize(clip_size);
+		o[1].resize(clip_size);
+		render_clip(zynayumi, clip, clip_size, o[0].data(), o[1].data());
+	}
+
+	double signal = 0.0, noise = 0.0;
+	max_diff = 0.0;
+	for (int c = 0; c < 2; c++) {
+		const std::vector<float>& ref = out[(int)Precision::Double][c];
+		const std::vector<float>& val = out[(int)Precision::Single][c];
+		for (unsigned long i = 0; i < clip_size; i++) {
+			double diff = (double)val[i] - ref[i];
+			signal += (double)ref[i] * ref[i];
+			noise += diff * diff;
+			max_diff = std::max(max_diff, std::abs(diff));
+		}
+	}
+	return noise == 0.0 ? INFINITY : 10.0 * std::log10(signal / noise);
+}
+
+} // ~namespace zynayumi
@@ -0,0 +1,79 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    clip.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_CLIP_HPP
+#define __ZYNAYUMI_CLIP_HPP
+
+#include <functional>
+#include <vector>
+
+#include "../zynayumi/zynayumi.hpp"
+
+// Canned MIDI clip rendered with the presets, shared by the
+// benchmarks and the tests
+
+namespace zynayumi {
+
+// Host block size
+const unsigned long CLIP_BLOCK_SIZE = 256;
+
+// Duration of the canned MIDI clip in second
+const double CLIP_DURATION = 2.0;
+
+// Minimum signal to difference ratio in dB of the single precision
+// render against the double precision one
+const double NULL_TEST_MIN_SNR = 90.0;
+
+// MIDI event stamped with its frame offset within the clip
+struct ClipEvent {
+	unsigned long frame;
+	unsigned char data[3];
+};
+
+// Build a 2 second clip at 120 BPM made of a bass line of eighth
+// notes followed by a held chord, for the given sample rate.
+std::vector<ClipEvent> canned_clip(int sample_rate);
+
+// Load a preset and a sample rate into zynayumi
+void load_preset(Zynayumi& zynayumi, unsigned preset, int sample_rate);
+
+// Render clip_size frames of the clip into left and right, by host
+// blocks of block_size frames. If provided, automate is called before
+// each host block with its first frame and size, to post parameter
+// changes.
+void render_clip(Zynayumi& zynayumi, const std::vector<ClipEvent>& clip,
+                 unsigned long clip_size, float* left, float* right,
+                 unsigned long block_size = CLIP_BLOCK_SIZE,
+                 const std::function<void(unsigned long, unsigned long)>& automate = {});
+
+// Null test of the single precision path against the double precision
+// one. Render the canned clip with a preset in both precisions, then
+// return the signal to difference ratio in dB, infinite if the
+// renders are identical, and set max_diff to the maximum absolute
+// difference.
+double precision_null_test(unsigned preset, int sample_rate, double& max_diff);
+
+} // ~namespace zynayumi
+
+#endif
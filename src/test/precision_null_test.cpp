@@ -0,0 +1,52 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    precision_null_test.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+// Null test of the single precision path against the double precision
+// one, over every preset. Fail if the signal to difference ratio of
+// any of them is below NULL_TEST_MIN_SNR.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "clip.hpp"
+#include "../zynayumi/programs.hpp"
+
+using namespace zynayumi;
+
+int main()
+{
+	const int sample_rate = 44100;
+	int status = EXIT_SUCCESS;
+	for (unsigned preset = 0; preset < Programs::count; preset++) {
+		double max_diff;
+		double snr = precision_null_test(preset, sample_rate, max_diff);
+		bool pass = NULL_TEST_MIN_SNR <= snr;
+		std::printf("%-30s max_diff=%g snr=%.1f dB %s\n",
+		            Programs::get_patch(preset).name.c_str(),
+		            max_diff, snr, pass ? "pass" : "FAIL");
+		if (not pass)
+			status = EXIT_FAILURE;
+	}
+	return status;
+}
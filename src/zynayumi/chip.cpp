@@ -0,0 +1,108 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    chip.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "chip.hpp"
+
+using namespace zynayumi;
+
+Chip::Chip(unsigned idx)
+	: index(idx)
+	, ay()
+	, buzzershape(Buzzer::Shape::Count)
+	, ringmodloop(RingMod::Loop::Count)
+	, ayenvshape(0)
+	, _write_counts()
+	, _change_counts()
+{
+	invalidate();
+}
+
+void Chip::configure(bool is_ym2149, int clock_rate, int sample_rate)
+{
+	ayumi_configure(&ay, is_ym2149, clock_rate, sample_rate);
+	invalidate();
+	set_envelope_shape(ayenvshape);
+}
+
+void Chip::invalidate()
+{
+	std::fill_n(_tone, CHANNEL_COUNT, -1.0);
+	_noise = -1;
+	std::fill_n(_mixer, CHANNEL_COUNT, -1);
+	std::fill_n(_volume, CHANNEL_COUNT, -1);
+	_envelope = -1;
+	std::fill_n(_pan, CHANNEL_COUNT, -1.0);
+}
+
+bool Chip::is_idle() const
+{
+	for (const tone_channel& channel : ay.channels)
+		if (channel.e_on or (channel.volume != 0
+		                     and not (channel.t_off and channel.n_off)))
+			return false;
+	return true;
+}
+
+void Chip::restart()
+{
+	for (tone_channel& channel : ay.channels) {
+		channel.tone_counter = 0;
+		channel.tone = 0;
+	}
+	ay.noise_counter = 0;
+	ay.noise = 1;
+	ayumi_set_envelope_shape(&ay, ay.envelope_shape);
+	ay.x = 0;
+}
+
+unsigned long Chip::get_write_count(Register reg) const
+{
+	return _write_counts[(int)reg];
+}
+
+unsigned long Chip::get_change_count(Register reg) const
+{
+	return _change_counts[(int)reg];
+}
+
+void Chip::get_registers(uint8_t* registers) const
+{
+	uint8_t mixer = 0;
+	for (int c = 0; c < CHANNEL_COUNT; c++) {
+		const tone_channel& channel = ay.channels[c];
+		long tone_period = std::clamp(std::lround(channel.tone_period), 1L, 0xfffL);
+		registers[2 * c] = tone_period & 0xff;
+		registers[2 * c + 1] = tone_period >> 8;
+		registers[8 + c] = channel.volume | (channel.e_on ? 0x10 : 0);
+		mixer |= channel.t_off << c | channel.n_off << (3 + c);
+	}
+	registers[6] = ay.noise_period;
+	registers[7] = mixer;
+	registers[11] = ay.envelope_period & 0xff;
+	registers[12] = ay.envelope_period >> 8;
+	registers[13] = ay.envelope_shape;
+}
@@ -0,0 +1,235 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    chip.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_CHIP_HPP
+#define __ZYNAYUMI_CHIP_HPP
+
+#include <cstdint>
+
+#include "patch.hpp"
+#include "decimator.hpp"
+
+extern "C"
+{
+#include "../../ayumi/ayumi.h"
+}
+
+namespace zynayumi {
+
+/**
+ * Emulated chip, an ayumi instance with its three YM channels, the
+ * envelope state last set by its voices and its output over a block.
+ *
+ * ayumi is written through a shadow register file, forwarding only
+ * the writes that change a value, and counting writes and changes
+ * per register.
+ */
+class Chip {
+public:
+
+	// Registers of the shadow register file, one per ayumi setter and
+	// channel
+	enum class Register {
+		Tone0,
+		Tone1,
+		Tone2,
+		Noise,
+		Mixer0,
+		Mixer1,
+		Mixer2,
+		Volume0,
+		Volume1,
+		Volume2,
+		Envelope,
+		EnvelopeShape,
+		Pan0,
+		Pan1,
+		Pan2,
+
+		Count
+	};
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const int CHANNEL_COUNT = 3;
+
+	// Number of sound registers of a real chip, R0 to R13, the I/O
+	// port registers excluded
+	static const int REGISTER_COUNT = 14;
+
+	// Maximum number of oversampled frames per block
+	static const int BUFFER_SIZE =
+		DecimatorBase::MAX_BLOCK_SIZE * DecimatorBase::MAX_FACTOR;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	Chip(unsigned index);
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// (Re)configure ayumi and restore its envelope shape. The shadow
+	// register file is invalidated so that the next writes all go
+	// through.
+	void configure(bool is_ym2149, int clock_rate, int sample_rate);
+
+	// Write ayumi, if that changes its state. The envelope shape is
+	// always written as that restarts the envelope.
+	void set_tone(int channel, double period);
+	void set_noise(int period);
+	void set_mixer(int channel, bool t_off, bool n_off, bool e_on);
+	void set_volume(int channel, int volume);
+	void set_envelope(int period);
+	void set_envelope_shape(int shape);
+	void set_pan(int channel, double pan);
+
+	// Number of writes of a register, and of those that changed it
+	// and were forwarded to ayumi, since construction
+	unsigned long get_write_count(Register reg) const;
+	unsigned long get_change_count(Register reg) const;
+
+	// Quantize the current ayumi state into the REGISTER_COUNT
+	// registers of a real chip. Tone periods are rounded to 12 bits.
+	void get_registers(uint8_t* registers) const;
+
+	// True iff ayumi outputs a constant, each channel being muted or
+	// having its tone and noise off, and none using the envelope
+	bool is_idle() const;
+
+	// Restart the tone, noise and envelope generators of ayumi, and
+	// the phase of its resampling, from the state ayumi_configure
+	// leaves them in. Meant for when the chip is idle, so that its
+	// output does not depend on how long it has run since.
+	void restart();
+
+	///////////////////
+	// Attributes    //
+	///////////////////
+
+	// Index of the chip within the engine
+	unsigned index;
+
+	// Current ayumi state
+	ayumi ay;
+
+	// Current buzzer shape
+	Buzzer::Shape buzzershape;
+
+	// Current ringmod loop
+	RingMod::Loop ringmodloop;
+
+	// Current ayumi envelope shape
+	int ayenvshape;
+
+	// Output of the current block, at the oversampled rate
+	double left[BUFFER_SIZE];
+	double right[BUFFER_SIZE];
+
+private:
+	// Mark all values of the shadow register file as unknown
+	void invalidate();
+
+	// Count a write of reg and return true iff value differs from
+	// shadow, then updated and counted as a change
+	template<typename T>
+	bool write(Register reg, T& shadow, T value);
+
+	// Values last forwarded to ayumi, negative if unknown
+	double _tone[CHANNEL_COUNT];
+	int _noise;
+	int _mixer[CHANNEL_COUNT];
+	int _volume[CHANNEL_COUNT];
+	int _envelope;
+	double _pan[CHANNEL_COUNT];
+
+	unsigned long _write_counts[(int)Register::Count];
+	unsigned long _change_counts[(int)Register::Count];
+};
+
+// Defined inline as they are called for every voice every sample
+
+template<typename T>
+inline bool Chip::write(Register reg, T& shadow, T value)
+{
+	_write_counts[(int)reg]++;
+	if (shadow == value)
+		return false;
+	shadow = value;
+	_change_counts[(int)reg]++;
+	return true;
+}
+
+inline void Chip::set_tone(int channel, double period)
+{
+	if (write((Register)((int)Register::Tone0 + channel), _tone[channel], period))
+		ayumi_set_tone(&ay, channel, period);
+}
+
+inline void Chip::set_noise(int period)
+{
+	if (write(Register::Noise, _noise, period))
+		ayumi_set_noise(&ay, period);
+}
+
+inline void Chip::set_mixer(int channel, bool t_off, bool n_off, bool e_on)
+{
+	int mixer = t_off | n_off << 1 | e_on << 2;
+	if (write((Register)((int)Register::Mixer0 + channel), _mixer[channel], mixer))
+		ayumi_set_mixer(&ay, channel, t_off, n_off, e_on);
+}
+
+inline void Chip::set_volume(int channel, int volume)
+{
+	if (write((Register)((int)Register::Volume0 + channel), _volume[channel], volume))
+		ayumi_set_volume(&ay, channel, volume);
+}
+
+inline void Chip::set_envelope(int period)
+{
+	if (write(Register::Envelope, _envelope, period))
+		ayumi_set_envelope(&ay, period);
+}
+
+inline void Chip::set_envelope_shape(int shape)
+{
+	_write_counts[(int)Register::EnvelopeShape]++;
+	_change_counts[(int)Register::EnvelopeShape]++;
+	ayumi_set_envelope_shape(&ay, shape);
+	ayenvshape = shape;
+}
+
+inline void Chip::set_pan(int channel, double pan)
+{
+	if (write((Register)((int)Register::Pan0 + channel), _pan[channel], pan))
+		ayumi_set_pan(&ay, channel, pan, 0);
+}
+
+} // ~namespace zynayumi
+
+#endif
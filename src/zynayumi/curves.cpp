@@ -0,0 +1,122 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    curves.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#include <cmath>
+
+#include "curves.hpp"
+
+using namespace zynayumi;
+
+LinearSegments::LinearSegments() : _count(0), _index(0) {}
+
+void LinearSegments::clear()
+{
+	_count = 0;
+	_index = 0;
+}
+
+void LinearSegments::add(double x1, double y1, double x2, double y2)
+{
+	if (_count == MAX_SEGMENTS)
+		return;
+	Segment& s = _segments[_count++];
+	s.x1 = x1;
+	s.x2 = x2;
+	if (0 != (x2 - x1)) {
+		s.slope = (y2 - y1) / (x2 - x1);
+		s.y1 = y1;
+	} else {
+		// Like Voice::linear_interpolate
+		s.slope = 0.0;
+		s.y1 = (y2 - y1) / 2.0;
+	}
+}
+
+void LinearSegments::rewind()
+{
+	_index = 0;
+}
+
+double LinearSegments::operator()(double x)
+{
+	while (_index < _count - 1 and _segments[_index].x2 < x)
+		_index++;
+	const Segment& s = _segments[_index];
+	return s.slope * (x - s.x1) + s.y1;
+}
+
+LogisticCurve::LogisticCurve()
+	: _flat(true), _y2(0.0), _mu(0.0), _inv_scale(0.0), _a(0.0), _b(0.0),
+	  _x(0.0), _e(0.0), _dx(0.0), _r(1.0), _valid(false) {}
+
+void LogisticCurve::configure(double x1, double y1, double x2, double y2,
+                              double scale, double sample_rate)
+{
+	_valid = false;
+	_dx = 0.0;
+	_r = 1.0;
+	_y2 = y2;
+
+	// Expedient case, no need to interpolate
+	static const double epsilon = 1e-6;
+	_flat = std::abs(y1 - y2) <= epsilon or scale <= epsilon;
+	if (_flat)
+		return;
+
+	// See Voice::logistic_interpolate for the derivation
+	double mu = ((x2 - x1) / 2.0) + x1;
+	double e1 = exp((mu - x1) / scale);
+	double e2 = exp((mu - x2) / scale);
+	_a = - (e1 * (-e2 - 1) * y2 + (-e2 - 1) * y2 + (e1 * (e2 + 1) + e2 + 1) * y1) / (e1 - e2);
+	_b = ((-e2 - 1) * y2 + (e1 + 1) * y1) / (e1 - e2);
+
+	// Convert in sample
+	_mu = mu * sample_rate;
+	_inv_scale = 1.0 / (scale * sample_rate);
+}
+
+double LogisticCurve::operator()(unsigned long smp_count)
+{
+	if (_flat)
+		return _y2;
+
+	// Step the exponential term if the increment is unchanged,
+	// otherwise recalculate it, as well as the step for the new
+	// increment.
+	double x = (double)smp_count;
+	double dx = x - _x;
+	if (_valid and dx == _dx) {
+		_e *= _r;
+	} else {
+		_e = exp(-(x - _mu) * _inv_scale);
+		if (_valid) {
+			_dx = dx;
+			_r = exp(-dx * _inv_scale);
+		}
+		_valid = true;
+	}
+	_x = x;
+	return _b + _a / (1.0 + _e);
+}
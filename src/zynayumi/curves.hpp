@@ -0,0 +1,135 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    curves.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#ifndef __ZYNAYUMI_CURVES_HPP
+#define __ZYNAYUMI_CURVES_HPP
+
+namespace zynayumi {
+
+/**
+ * Piecewise linear curve with precomputed segment slopes, used for the
+ * amplitude envelope.
+ *
+ * Evaluating it is a multiply-add. Segments are walked incrementally,
+ * thus successive evaluations must be at non-decreasing x, unless
+ * rewind is called in between.
+ */
+class LinearSegments {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const int MAX_SEGMENTS = 5;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	LinearSegments();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Remove all segments
+	void clear();
+
+	// Append a segment from (x1, y1) to (x2, y2), behaving like
+	// Voice::linear_interpolate over it. The last segment extends to
+	// infinity. Segments beyond MAX_SEGMENTS are ignored.
+	void add(double x1, double y1, double x2, double y2);
+
+	// Go back to the first segment
+	void rewind();
+
+	// Evaluate at x over the first segment such that x <= x2. Undefined
+	// if empty.
+	double operator()(double x);
+
+private:
+	struct Segment {
+		double x1, x2;          // Boundaries
+		double slope;           // (y2 - y1) / (x2 - x1)
+		double y1;              // Value at x1
+	};
+
+	Segment _segments[MAX_SEGMENTS];
+	int _count;
+	int _index;                 // Current segment
+};
+
+/**
+ * Logistic curve with precomputed coefficients, used for the pitch
+ * envelope and portamento.
+ *
+ * Coordinates are in second but the curve is evaluated at sample
+ * counts, so that the exponential term can be updated by a
+ * multiplication when the sample count is increased by the same
+ * amount as the previous evaluation, which is the case when
+ * evaluating at control rate. Thus exp is only called when the
+ * increment changes.
+ */
+class LogisticCurve {
+public:
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	LogisticCurve();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Set the curve going from (x1, y1) to (x2, y2), so that it
+	// matches Voice::logistic_interpolate(x1, y1, x2, y2, x, scale)
+	// with x = smp_count / sample_rate.
+	void configure(double x1, double y1, double x2, double y2,
+	               double scale, double sample_rate);
+
+	// Evaluate at smp_count
+	double operator()(unsigned long smp_count);
+
+private:
+	bool _flat;                 // Whether the curve is constant, y2
+	double _y2;
+
+	double _mu;                 // Inflection point, in sample
+	double _inv_scale;          // Inverse of scale, in sample
+	double _a, _b;              // y = b + a / (1 + e)
+
+	double _x;                  // Last evaluated sample count
+	double _e;                  // exp(-(_x - _mu) / scale)
+	double _dx;                 // Last increment of _x
+	double _r;                  // exp(-_dx / scale)
+	bool _valid;                // Whether _x and _e are defined
+};
+
+} // ~namespace zynayumi
+
+#endif
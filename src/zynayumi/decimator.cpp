@@ -0,0 +1,312 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    decimator.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "decimator.hpp"
+
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define ZYNAYUMI_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace zynayumi;
+
+namespace {
+
+// Dot products of symmetric coefficients, folding each pair of
+// samples sharing the same coefficient. taps is assumed odd.
+template<typename T>
+void dot_product_scalar(const T* coefs, int taps,
+                        const T* left, const T* right,
+                        T& yl, T& yr)
+{
+	const int half = taps / 2;
+	const T* lm = left + taps - 1;
+	const T* rm = right + taps - 1;
+	T al = coefs[half] * left[half];
+	T ar = coefs[half] * right[half];
+	for (int n = 0; n < half; n++) {
+		al += coefs[n] * (left[n] + lm[-n]);
+		ar += coefs[n] * (right[n] + rm[-n]);
+	}
+	yl = al;
+	yr = ar;
+}
+
+#ifdef ZYNAYUMI_X86_KERNELS
+
+__attribute__((target("sse2")))
+void dot_product_sse2(const double* coefs, int taps,
+                      const double* left, const double* right,
+                      double& yl, double& yr)
+{
+	const int half = taps / 2;
+	__m128d al = _mm_setzero_pd();
+	__m128d ar = _mm_setzero_pd();
+	int n = 0;
+	for (; n + 2 <= half; n += 2) {
+		// Mirrored samples, loaded then reversed
+		const int m = taps - 2 - n;
+		__m128d c = _mm_loadu_pd(coefs + n);
+		__m128d lm = _mm_loadu_pd(left + m);
+		__m128d rm = _mm_loadu_pd(right + m);
+		__m128d l = _mm_add_pd(_mm_loadu_pd(left + n), _mm_shuffle_pd(lm, lm, 1));
+		__m128d r = _mm_add_pd(_mm_loadu_pd(right + n), _mm_shuffle_pd(rm, rm, 1));
+		al = _mm_add_pd(al, _mm_mul_pd(c, l));
+		ar = _mm_add_pd(ar, _mm_mul_pd(c, r));
+	}
+	double sl[2], sr[2];
+	_mm_storeu_pd(sl, al);
+	_mm_storeu_pd(sr, ar);
+	double ol = coefs[half] * left[half] + sl[0] + sl[1];
+	double or_ = coefs[half] * right[half] + sr[0] + sr[1];
+	for (; n < half; n++) {
+		ol += coefs[n] * (left[n] + left[taps - 1 - n]);
+		or_ += coefs[n] * (right[n] + right[taps - 1 - n]);
+	}
+	yl = ol;
+	yr = or_;
+}
+
+__attribute__((target("avx2,fma")))
+void dot_product_avx2(const double* coefs, int taps,
+                      const double* left, const double* right,
+                      double& yl, double& yr)
+{
+	const int half = taps / 2;
+	__m256d al = _mm256_setzero_pd();
+	__m256d ar = _mm256_setzero_pd();
+	int n = 0;
+	for (; n + 4 <= half; n += 4) {
+		// Mirrored samples, loaded then reversed
+		const int m = taps - 4 - n;
+		__m256d c = _mm256_loadu_pd(coefs + n);
+		__m256d lm = _mm256_permute4x64_pd(_mm256_loadu_pd(left + m), 0x1b);
+		__m256d rm = _mm256_permute4x64_pd(_mm256_loadu_pd(right + m), 0x1b);
+		__m256d l = _mm256_add_pd(_mm256_loadu_pd(left + n), lm);
+		__m256d r = _mm256_add_pd(_mm256_loadu_pd(right + n), rm);
+		al = _mm256_fmadd_pd(c, l, al);
+		ar = _mm256_fmadd_pd(c, r, ar);
+	}
+	double sl[4], sr[4];
+	_mm256_storeu_pd(sl, al);
+	_mm256_storeu_pd(sr, ar);
+	double ol = coefs[half] * left[half] + ((sl[0] + sl[1]) + (sl[2] + sl[3]));
+	double or_ = coefs[half] * right[half] + ((sr[0] + sr[1]) + (sr[2] + sr[3]));
+	for (; n < half; n++) {
+		ol += coefs[n] * (left[n] + left[taps - 1 - n]);
+		or_ += coefs[n] * (right[n] + right[taps - 1 - n]);
+	}
+	yl = ol;
+	yr = or_;
+}
+
+__attribute__((target("sse2")))
+void dot_product_sse2(const float* coefs, int taps,
+                      const float* left, const float* right,
+                      float& yl, float& yr)
+{
+	const int half = taps / 2;
+	__m128 al = _mm_setzero_ps();
+	__m128 ar = _mm_setzero_ps();
+	int n = 0;
+	for (; n + 4 <= half; n += 4) {
+		// Mirrored samples, loaded then reversed
+		const int m = taps - 4 - n;
+		__m128 c = _mm_loadu_ps(coefs + n);
+		__m128 lm = _mm_loadu_ps(left + m);
+		__m128 rm = _mm_loadu_ps(right + m);
+		__m128 l = _mm_add_ps(_mm_loadu_ps(left + n), _mm_shuffle_ps(lm, lm, 0x1b));
+		__m128 r = _mm_add_ps(_mm_loadu_ps(right + n), _mm_shuffle_ps(rm, rm, 0x1b));
+		al = _mm_add_ps(al, _mm_mul_ps(c, l));
+		ar = _mm_add_ps(ar, _mm_mul_ps(c, r));
+	}
+	float sl[4], sr[4];
+	_mm_storeu_ps(sl, al);
+	_mm_storeu_ps(sr, ar);
+	float ol = coefs[half] * left[half] + ((sl[0] + sl[1]) + (sl[2] + sl[3]));
+	float or_ = coefs[half] * right[half] + ((sr[0] + sr[1]) + (sr[2] + sr[3]));
+	for (; n < half; n++) {
+		ol += coefs[n] * (left[n] + left[taps - 1 - n]);
+		or_ += coefs[n] * (right[n] + right[taps - 1 - n]);
+	}
+	yl = ol;
+	yr = or_;
+}
+
+__attribute__((target("avx2,fma")))
+void dot_product_avx2(const float* coefs, int taps,
+                      const float* left, const float* right,
+                      float& yl, float& yr)
+{
+	const int half = taps / 2;
+	const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	__m256 al = _mm256_setzero_ps();
+	__m256 ar = _mm256_setzero_ps();
+	int n = 0;
+	for (; n + 8 <= half; n += 8) {
+		// Mirrored samples, loaded then reversed
+		const int m = taps - 8 - n;
+		__m256 c = _mm256_loadu_ps(coefs + n);
+		__m256 lm = _mm256_permutevar8x32_ps(_mm256_loadu_ps(left + m), reverse);
+		__m256 rm = _mm256_permutevar8x32_ps(_mm256_loadu_ps(right + m), reverse);
+		__m256 l = _mm256_add_ps(_mm256_loadu_ps(left + n), lm);
+		__m256 r = _mm256_add_ps(_mm256_loadu_ps(right + n), rm);
+		al = _mm256_fmadd_ps(c, l, al);
+		ar = _mm256_fmadd_ps(c, r, ar);
+	}
+	float sl[8], sr[8];
+	_mm256_storeu_ps(sl, al);
+	_mm256_storeu_ps(sr, ar);
+	float ol = coefs[half] * left[half]
+		+ (((sl[0] + sl[1]) + (sl[2] + sl[3])) + ((sl[4] + sl[5]) + (sl[6] + sl[7])));
+	float or_ = coefs[half] * right[half]
+		+ (((sr[0] + sr[1]) + (sr[2] + sr[3])) + ((sr[4] + sr[5]) + (sr[6] + sr[7])));
+	for (; n < half; n++) {
+		ol += coefs[n] * (left[n] + left[taps - 1 - n]);
+		or_ += coefs[n] * (right[n] + right[taps - 1 - n]);
+	}
+	yl = ol;
+	yr = or_;
+}
+
+#endif
+
+} // ~namespace
+
+DecimatorBase::Kernel DecimatorBase::best_kernel()
+{
+#ifdef ZYNAYUMI_X86_KERNELS
+	if (__builtin_cpu_supports("avx2") and __builtin_cpu_supports("fma"))
+		return Kernel::AVX2;
+	if (__builtin_cpu_supports("sse2"))
+		return Kernel::SSE2;
+#endif
+	return Kernel::Scalar;
+}
+
+template<typename T>
+Decimator<T>::Decimator()
+{
+	set_kernel(best_kernel());
+	configure(1);
+}
+
+template<typename T>
+void Decimator<T>::configure(int factor)
+{
+	_factor = std::clamp(factor, 1, MAX_FACTOR);
+	_taps = _factor == 1 ? 1 : TAPS_PER_FACTOR * _factor + 1;
+	std::fill(std::begin(_left), std::end(_left), T(0));
+	std::fill(std::begin(_right), std::end(_right), T(0));
+
+	// Blackman windowed sinc with cutoff at the host Nyquist
+	// frequency, normalized so that the DC gain is 1. The second half
+	// mirrors the first one so that the filter is exactly symmetric.
+	const double cutoff = 0.5 / _factor;
+	const int middle = _taps / 2;
+	double coefs[MAX_TAPS];
+	double sum = 0.0;
+	for (int n = 0; n < _taps; n++) {
+		if (middle < n) {
+			coefs[n] = coefs[_taps - 1 - n];
+			sum += coefs[n];
+			continue;
+		}
+		double x = 2.0 * cutoff * (n - middle);
+		double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+		double w = _taps == 1 ? 1.0 :
+			0.42 - 0.5 * std::cos(2.0 * M_PI * n / (_taps - 1))
+			+ 0.08 * std::cos(4.0 * M_PI * n / (_taps - 1));
+		coefs[n] = sinc * w;
+		sum += coefs[n];
+	}
+	for (int n = 0; n < _taps; n++)
+		_coefs[n] = coefs[n] / sum;
+}
+
+template<typename T>
+int Decimator<T>::get_factor() const
+{
+	return _factor;
+}
+
+template<typename T>
+void Decimator<T>::set_kernel(Kernel kernel)
+{
+	_kernel = std::min(kernel, best_kernel());
+	switch (_kernel) {
+#ifdef ZYNAYUMI_X86_KERNELS
+	case Kernel::AVX2:
+		_dot_product = dot_product_avx2;
+		break;
+	case Kernel::SSE2:
+		_dot_product = dot_product_sse2;
+		break;
+#endif
+	default:
+		_kernel = Kernel::Scalar;
+		_dot_product = dot_product_scalar<T>;
+		break;
+	}
+}
+
+template<typename T>
+DecimatorBase::Kernel Decimator<T>::get_kernel() const
+{
+	return _kernel;
+}
+
+template<typename T>
+void Decimator<T>::process_block(const T* left_in, const T* right_in,
+                                 int count, T* left_out, T* right_out)
+{
+	// Append the block to the history
+	const int history = _taps - 1;
+	const int size = count * _factor;
+	std::copy(left_in, left_in + size, _left + history);
+	std::copy(right_in, right_in + size, _right + history);
+
+	// Each output frame is the dot product of the coefficients with
+	// the last _taps samples, oldest first.
+	for (int i = 0; i < count; i++) {
+		const int start = (i + 1) * _factor - 1;
+		_dot_product(_coefs, _taps, _left + start, _right + start,
+		             left_out[i], right_out[i]);
+	}
+
+	// Keep the last _taps - 1 samples for the next block
+	std::copy(_left + size, _left + size + history, _left);
+	std::copy(_right + size, _right + size + history, _right);
+}
+
+namespace zynayumi {
+
+template class Decimator<float>;
+template class Decimator<double>;
+
+} // ~namespace zynayumi
@@ -0,0 +1,138 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    decimator.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_DECIMATOR_HPP
+#define __ZYNAYUMI_DECIMATOR_HPP
+
+namespace zynayumi {
+
+/**
+ * Constants and kernel selection shared by the decimators of all
+ * sample types.
+ */
+class DecimatorBase {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const int MAX_FACTOR = 4;
+
+	// Number of taps per unit of decimation factor
+	static const int TAPS_PER_FACTOR = 32;
+
+	static const int MAX_TAPS = TAPS_PER_FACTOR * MAX_FACTOR + 1;
+
+	// Maximum number of decimated frames per block
+	static const int MAX_BLOCK_SIZE = 64;
+
+	// Implementations of the dot products
+	enum class Kernel {
+		Scalar,
+		SSE2,
+		AVX2,
+
+		Count
+	};
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Return the fastest kernel supported by the CPU
+	static Kernel best_kernel();
+};
+
+/**
+ * Stereo low pass FIR filter bringing the oversampled output of
+ * ayumi back to the host sample rate, with samples of type T, float
+ * or double.
+ *
+ * Coefficients are calculated in double by configure, then converted
+ * to T. configure does not allocate and can thus be called from the
+ * audio thread. Samples are filtered by blocks over a contiguous
+ * buffer. The filter being symmetric, its coefficients are folded so
+ * that each one is only multiplied once, by the sum of the two
+ * samples it applies to. The dot products are calculated by an AVX2,
+ * SSE2 or scalar kernel, selected at run time according to the CPU.
+ * In single precision the SIMD kernels process twice as many taps
+ * per instruction.
+ */
+template<typename T>
+class Decimator : public DecimatorBase {
+public:
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	Decimator();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Set the decimation factor, within [1, MAX_FACTOR], calculate the
+	// filter coefficients and clear the history.
+	void configure(int factor);
+
+	int get_factor() const;
+
+	// Select the kernel, falling back to the best supported one if
+	// the CPU does not support it. By default the best one is used.
+	void set_kernel(Kernel kernel);
+	Kernel get_kernel() const;
+
+	// Decimate count * factor oversampled stereo frames into count
+	// frames, count being at most MAX_BLOCK_SIZE.
+	void process_block(const T* left_in, const T* right_in,
+	                   int count, T* left_out, T* right_out);
+
+private:
+	// Calculate the dot products of the coefficients with the taps
+	// samples of left and right
+	typedef void (*DotProduct)(const T* coefs, int taps,
+	                           const T* left, const T* right,
+	                           T& yl, T& yr);
+
+	int _factor;
+	int _taps;
+	Kernel _kernel;
+	DotProduct _dot_product;
+
+	// Filter coefficients
+	T _coefs[MAX_TAPS];
+
+	// Work buffer of each channel, starting with the last _taps - 1
+	// samples of the previous block followed by the samples of the
+	// current block.
+	static const int WORK_SIZE = MAX_TAPS - 1 + MAX_BLOCK_SIZE * MAX_FACTOR;
+	T _left[WORK_SIZE];
+	T _right[WORK_SIZE];
+};
+
+} // ~namespace zynayumi
+
+#endif
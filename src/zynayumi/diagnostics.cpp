@@ -0,0 +1,143 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    diagnostics.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <sstream>
+
+#include "diagnostics.hpp"
+
+using namespace zynayumi;
+
+Diagnostics::Diagnostics() : _write(0), _read(0), _dropped(0), _trace(false)
+{
+	for (unsigned i = 0; i < CAPACITY; i++)
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	for (auto& c : _counts)
+		c.store(0, std::memory_order_relaxed);
+}
+
+bool Diagnostics::push(Code code, int arg0, int arg1, int arg2)
+{
+	_counts[(size_t)code].fetch_add(1, std::memory_order_relaxed);
+
+	// Bounded multi-producer queue a la Dmitry Vyukov. Each slot
+	// holds a sequence number telling whether it is free for the
+	// position being written (sequence == pos) or holds a message
+	// ready to be read (sequence == pos + 1).
+	unsigned pos = _write.load(std::memory_order_relaxed);
+	Slot* slot;
+	for (;;) {
+		slot = &_slots[pos & (CAPACITY - 1)];
+		unsigned seq = slot->sequence.load(std::memory_order_acquire);
+		int diff = (int)(seq - pos);
+		if (diff == 0) {
+			if (_write.compare_exchange_weak(pos, pos + 1,
+			                                 std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// Full
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		} else {
+			pos = _write.load(std::memory_order_relaxed);
+		}
+	}
+	slot->msg.code = code;
+	slot->msg.args[0] = arg0;
+	slot->msg.args[1] = arg1;
+	slot->msg.args[2] = arg2;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool Diagnostics::pop(Message& msg)
+{
+	Slot& slot = _slots[_read & (CAPACITY - 1)];
+	unsigned seq = slot.sequence.load(std::memory_order_acquire);
+	if ((int)(seq - (_read + 1)) < 0)
+		return false;
+	msg = slot.msg;
+	slot.sequence.store(_read + CAPACITY, std::memory_order_release);
+	_read++;
+	return true;
+}
+
+unsigned Diagnostics::drain(std::ostream& os)
+{
+	unsigned n = 0;
+	Message msg;
+	while (pop(msg)) {
+		os << to_string(msg) << std::endl;
+		n++;
+	}
+	return n;
+}
+
+unsigned long Diagnostics::count(Code code) const
+{
+	return _counts[(size_t)code].load(std::memory_order_relaxed);
+}
+
+unsigned long Diagnostics::dropped() const
+{
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+void Diagnostics::set_trace(bool enabled)
+{
+	_trace.store(enabled, std::memory_order_relaxed);
+}
+
+bool Diagnostics::is_trace() const
+{
+	return _trace.load(std::memory_order_relaxed);
+}
+
+std::string Diagnostics::to_string(const Message& msg)
+{
+	std::stringstream ss;
+	switch (msg.code) {
+	case Code::UnsupportedControlChange:
+		ss << "Control change " << msg.args[0] << " unsupported";
+		break;
+	case Code::UnsupportedMidiEvent:
+		ss << "Midi event (status=" << msg.args[0]
+		   << ", byte1=" << msg.args[1]
+		   << ", byte2=" << msg.args[2]
+		   << ") not implemented";
+		break;
+	case Code::UnexpectedCase:
+		ss << "Case not implemented (line " << msg.args[0]
+		   << "), there's likely a bug";
+		break;
+	case Code::SeqStep:
+		ss << "Voice " << msg.args[0]
+		   << " seq step = " << msg.args[1]
+		   << ", seq index = " << msg.args[2];
+		break;
+	default:
+		ss << "Unknown diagnostic code " << (int)msg.code;
+		break;
+	}
+	return ss.str();
+}
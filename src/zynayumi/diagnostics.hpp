@@ -0,0 +1,126 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    diagnostics.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_DIAGNOSTICS_HPP
+#define __ZYNAYUMI_DIAGNOSTICS_HPP
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+namespace zynayumi {
+
+/**
+ * Lock-free ring buffer of diagnostic messages.
+ *
+ * Messages are pushed from the real-time threads (audio and MIDI
+ * processing) without locking, allocating or touching any stream,
+ * and drained by a single non real-time thread, for instance the
+ * GUI or a timer of the plugin.  If the buffer is full the message is
+ * dropped and counted as such.  Every pushed message is also counted
+ * per code, whether dropped or not.
+ */
+class Diagnostics {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Must be a power of 2
+	static const unsigned CAPACITY = 256;
+
+	enum class Code {
+		UnsupportedControlChange, // args = {cc, value}
+		UnsupportedMidiEvent,     // args = {status, byte1, byte2}
+		UnexpectedCase,           // args = {source line}
+		SeqStep,                  // args = {ym channel, step, index}
+
+		Count
+	};
+
+	struct Message {
+		Code code;
+		int args[3];
+	};
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	Diagnostics();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Push a message. Real-time safe and can be called concurrently
+	// from several threads. Return false if the message was dropped
+	// because the buffer is full.
+	bool push(Code code, int arg0 = 0, int arg1 = 0, int arg2 = 0);
+
+	// Pop the oldest message. Must only be called by a single non
+	// real-time thread. Return false if there is no message.
+	bool pop(Message& msg);
+
+	// Pop all messages and write them to os, one per line. Return the
+	// number of messages written.
+	unsigned drain(std::ostream& os);
+
+	// Number of messages pushed with a given code, including dropped
+	// ones.
+	unsigned long count(Code code) const;
+
+	// Number of dropped messages
+	unsigned long dropped() const;
+
+	// Enable/disable trace messages (such as SeqStep), disabled by
+	// default as they are very frequent.
+	void set_trace(bool enabled);
+	bool is_trace() const;
+
+	static std::string to_string(const Message& msg);
+
+private:
+	struct Slot {
+		std::atomic<unsigned> sequence;
+		Message msg;
+	};
+
+	Slot _slots[CAPACITY];
+
+	// Next position to write, shared by producers
+	std::atomic<unsigned> _write;
+
+	// Next position to read, only accessed by the consumer
+	unsigned _read;
+
+	std::atomic<unsigned long> _counts[(size_t)Code::Count];
+	std::atomic<unsigned long> _dropped;
+	std::atomic<bool> _trace;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -23,6 +23,7 @@
 
 ****************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <assert.h>
@@ -30,22 +31,42 @@
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/algorithm/count.hpp>
-#include <boost/range/algorithm_ext/erase.hpp>
 
 #include "engine.hpp"
+#include "parameters.hpp"
 #include "zynayumi.hpp"
+#include "registerstream.hpp"
 
 namespace zynayumi {
 
+namespace {
+
+// Return the default of a parameter in type T
+template<typename T>
+T dflt(ParameterIndex pi)
+{
+	return (T)(int)Parameters::get_descriptor(pi).dflt;
+}
+
+// Return the engine settings set to the defaults of their parameters
+EngineSettings default_settings()
+{
+	return {dflt<int>(OVERSAMPLING),
+	        dflt<int>(CONTROL_PERIOD),
+	        dflt<int>(CHIP_COUNT),
+	        dflt<SmoothingMode>(SMOOTHING_MODE),
+	        Parameters::get_descriptor(SMOOTHING_TIME).dflt};
+}
+
+} // ~namespace
+
 // Constructor destructor
 Engine::Engine(const Zynayumi& ref)
-	: _zynayumi(ref),
+	: EngineSettings(default_settings()),
+	  _zynayumi(ref),
 	  emulmode(EmulMode::YM2149),
 	  cantusmode(CantusMode::Mono),
 	  playmode(PlayMode::Legato),
-	  buzzershape(Buzzer::Shape::Count),
-	  ringmodloop(RingMod::Loop::Count),
-	  ayenvshape(0),
 	  previous_pitch(-1),
 	  last_pitch(-1),
 	  lower_note_freq(8.1757989156),
@@ -67,18 +88,37 @@ Engine::Engine(const Zynayumi& ref)
 	  pan(0.5),
 	  expression_gain(vol2gain(127)),
 	  sustain_pedal(false),
-	  oversampling(2)
-{
-	_voices.emplace_back(*this, _zynayumi.patch, 0);
-	_voices.emplace_back(*this, _zynayumi.patch, 1);
-	_voices.emplace_back(*this, _zynayumi.patch, 2);
-	ayumi_configure(&ay, 1, clock_rate, sample_rate);
+#ifdef ZYNAYUMI_SINGLE_PRECISION
+	  precision(Precision::Single),
+#else
+	  precision(Precision::Double),
+#endif
+	  register_capture(nullptr),
+	  register_player(nullptr),
+	  _chip_count(chip_count),
+	  _random_state(1),
+	  _oversampling(oversampling),
+	  _idle_frames(0),
+	  _precision(precision),
+	  _smoothing_mode(smoothing_mode),
+	  _smoothing_time(smoothing_time),
+	  _smoothers_reset(false)
+{
+	static_assert(MAX_CHIPS * Chip::CHANNEL_COUNT <= ChannelMask::CAPACITY);
+	chips.reserve(MAX_CHIPS);
+	_voices.reserve(MAX_CHIPS * Chip::CHANNEL_COUNT);
+	resize_chips();
+	configure_ayumi();
+	configure_smoothers();
+	for (double* values : _smoothed)
+		std::fill_n(values, BLOCK_SIZE, 0.0);
 }
 
 void Engine::set_sample_rate(int sr)
 {
 	sample_rate = sr;
-	ayumi_configure(&ay, emulmode == EmulMode::YM2149, clock_rate, sample_rate);
+	configure_ayumi();
+	configure_smoothers();
 }
 
 void Engine::set_bpm(double b)
@@ -86,16 +126,69 @@ void Engine::set_bpm(double b)
 	bpm = b;
 }
 
-void Engine::audio_process(float* left_out, float* right_out,
+void Engine::set_worker_count(int count, const std::vector<int>& cpus)
+{
+	_worker_pool.start(count, cpus);
+}
+
+int Engine::get_worker_count() const
+{
+	return _worker_pool.size();
+}
+
+bool Engine::audio_process(float* left_out, float* right_out,
                            unsigned long sample_count)
 {
-	// Switch to the correct emulation mode (YM2149 or YM8910)
-	if (_zynayumi.patch.emulmode != emulmode) {
-		bool is_ym2149 = _zynayumi.patch.emulmode == EmulMode::YM2149;
-		clock_rate = is_ym2149 ? YM2149_CLOCK_RATE : AY8910_CLOCK_RATE;
-		ayumi_configure(&ay, is_ym2149, clock_rate, sample_rate);
-		ayumi_set_envelope_shape(&ay, ayenvshape);
-		emulmode = _zynayumi.patch.emulmode;
+	// Switch to the correct emulation mode (YM2149 or YM8910), or to
+	// the chips of the register stream being played
+	EmulMode new_emulmode = _zynayumi.patch.emulmode;
+	int new_clock_rate = new_emulmode == EmulMode::YM2149 ?
+		YM2149_CLOCK_RATE : AY8910_CLOCK_RATE;
+	int new_chip_count = std::clamp(chip_count, 1, MAX_CHIPS);
+	if (register_player) {
+		const RegisterStream& stream = register_player->get_stream();
+		new_emulmode = stream.is_ym2149() ? EmulMode::YM2149 : EmulMode::AY8910;
+		new_clock_rate = stream.get_clock_rate();
+		new_chip_count = std::clamp<int>(stream.get_chip_count(), 1, MAX_CHIPS);
+	}
+	if (new_emulmode != emulmode or new_clock_rate != clock_rate) {
+		emulmode = new_emulmode;
+		clock_rate = new_clock_rate;
+		configure_ayumi();
+	}
+
+	// Switch to the requested oversampling
+	if (oversampling != _oversampling) {
+		_oversampling = oversampling;
+		configure_ayumi();
+	}
+
+	// Add or remove chips
+	if (new_chip_count != _chip_count) {
+		_chip_count = new_chip_count;
+		resize_chips();
+		configure_ayumi();
+	}
+
+	// Switch to the requested precision
+	if (precision != _precision) {
+		_precision = precision;
+		configure_ayumi();
+	}
+
+	// Switch to the requested smoothing
+	if (smoothing_mode != _smoothing_mode or smoothing_time != _smoothing_time) {
+		_smoothing_mode = smoothing_mode;
+		_smoothing_time = smoothing_time;
+		configure_smoothers();
+	}
+
+	// Start the smoothed parameters from the patch rather than ramping
+	// from their defaults
+	if (not _smoothers_reset) {
+		for (int s = 0; s < (int)Smoothed::Count; s++)
+			_smoothers[s].reset(get_smoothed_target((Smoothed)s));
+		_smoothers_reset = true;
 	}
 
 	// Send off notes in case cantusmode went from poly to mono or unison
@@ -117,21 +210,64 @@ void Engine::audio_process(float* left_out, float* right_out,
 		cantusmode = _zynayumi.patch.cantusmode;
 	}
 
-	for (unsigned long i = 0; i < sample_count; i++) {
-		// Update voice states (which modulates the ayumi state)
-		for (Voice& v : _voices)
-			v.update();
+	bool silent = true;
+	for (unsigned long i = 0; i < sample_count;) {
+		int count = std::min<unsigned long>(BLOCK_SIZE, sample_count - i);
 
-		// Process ayumi
-		ayumi_process(&ay);
-		ayumi_remove_dc(&ay);
+		// Split blocks at the frame boundaries of the playback, and
+		// write the registers of the frame starting the block
+		if (register_player) {
+			count = std::min<unsigned long>(
+				count, register_player->get_remaining(sample_rate));
+			register_player->process(chips, sample_rate, count);
+		}
+
+		// Split blocks at the frame boundaries of the capture
+		if (register_capture)
+			count = std::min<unsigned long>(
+				count, register_capture->get_remaining(sample_rate));
+
+		// Split blocks where the filters have settled once the chips
+		// are idle, so that the skip below starts at a fixed frame
+		bool idle = is_idle();
+		if (idle and _idle_frames < SILENCE_DELAY)
+			count = std::min(count, SILENCE_DELAY - _idle_frames);
+
+		// Ramp the smoothed parameters over the block. The voices set
+		// the panning, except during playback.
+		smooth(count);
+		if (register_player)
+			for (Chip& chip : chips)
+				for (int c = 0; c < Chip::CHANNEL_COUNT; c++)
+					chip.set_pan(c, get_smoothed(
+						             (Smoothed)((int)Smoothed::Pan0 + c), 0));
+
+		// Skip rendering once the chips have been idle long enough for
+		// the filters to settle, their output being then null.
+		// Otherwise render and count the idle frames. The generators
+		// of the chips are restarted as the skip starts, since they
+		// are paused during it, so that rendering resumes from the
+		// same state whatever the block sizes.
+		if (idle and SILENCE_DELAY <= _idle_frames) {
+			std::fill_n(left_out + i, count, 0.0f);
+			std::fill_n(right_out + i, count, 0.0f);
+		} else {
+			if (_precision == Precision::Single)
+				render_block(_single_renderer, left_out + i, right_out + i, count);
+			else
+				render_block(_double_renderer, left_out + i, right_out + i, count);
+			_idle_frames = idle ? _idle_frames + count : 0;
+			if (_idle_frames == SILENCE_DELAY)
+				for (Chip& chip : chips)
+					chip.restart();
+			silent = false;
+		}
 
-		// Update outputs
-		left_out[i] = (float)ay.left * (1.0f - pan) *
-			_zynayumi.patch.mixer.gain * volume_gain * expression_gain;
-		right_out[i] = (float)ay.right * pan *
-			_zynayumi.patch.mixer.gain * volume_gain * expression_gain;
+		if (register_capture)
+			register_capture->process(*this, count);
+		i += count;
 	}
+	return silent;
 }
 
 void Engine::note_on_process(unsigned char channel,
@@ -258,7 +394,7 @@ void Engine::note_off_process(unsigned char channel, unsigned char pitch)
 			if (pitches.empty()) {
 				set_note_off_with_pitch(pitch);
 			} else if (pitches.size() == 1) {
-				unsigned char last_pitch = *pitches.begin();
+				unsigned char last_pitch = pitches.min();
 				for (Voice& v : _voices) {
 					if (v.note_on) {
 						v.set_note_pitch(last_pitch);
@@ -295,7 +431,7 @@ void Engine::note_off_process(unsigned char channel, unsigned char pitch)
 			if (pitches.empty()) {
 				set_note_off_all_voices();
 			} else if (pitches.size() == 1) {
-				unsigned char last_pitch = *pitches.begin();
+				unsigned char last_pitch = pitches.min();
 				for (Voice& v : _voices) {
 					if (v.note_on) {
 						v.set_note_pitch(last_pitch);
@@ -368,9 +504,9 @@ void Engine::sustain_pedal_process(unsigned char channel, unsigned char value)
 {
 	sustain_pedal = 64 <= value;
 	if (not sustain_pedal) {
-		for (auto it = sustain_pitches.begin(); it != sustain_pitches.end();) {
-			unsigned char pitch = *it;
-			it = erase_sustain_pitch(pitch);
+		while (not sustain_pitches.empty()) {
+			unsigned char pitch = sustain_pitches.min();
+			erase_sustain_pitch(pitch);
 			note_off_process(channel, pitch);
 		}
 	}
@@ -378,12 +514,16 @@ void Engine::sustain_pedal_process(unsigned char channel, unsigned char value)
 
 void Engine::enable_ym_channel(unsigned char ym_channel)
 {
-	_voices[ym_channel].enable();
+	for (Voice& v : _voices)
+		if (v.ym_channel == ym_channel)
+			v.enable();
 }
 
 void Engine::disable_ym_channel(unsigned char ym_channel)
 {
-	_voices[ym_channel].disable();
+	for (Voice& v : _voices)
+		if (v.ym_channel == ym_channel)
+			v.disable();
 }
 
 std::string Engine::to_string(const std::string& indent) const
@@ -391,16 +531,16 @@ std::string Engine::to_string(const std::string& indent) const
 	std::string di = indent + indent;
 	std::stringstream ss;
 	ss << indent << "pitches:";
-	for (unsigned char p : pitches)
-		ss << " " << (int)p;
+	for (unsigned i = 0; i < pitches.size(); i++)
+		ss << " " << (int)pitches[i];
 	ss << std::endl;
 	ss << indent << "pitch_stack:";
 	for (unsigned char p : pitch_stack)
 		ss << " " << (int)p;
 	ss << std::endl;
 	ss << indent << "sustain pitches:";
-	for (unsigned char p : sustain_pitches)
-		ss << " " << (int)p;
+	for (unsigned i = 0; i < sustain_pitches.size(); i++)
+		ss << " " << (int)sustain_pitches[i];
 	ss << std::endl;
 	ss << indent << "previous_pitch = " << previous_pitch << std::endl;
 	ss << indent << "last_pitch = " << last_pitch;
@@ -409,24 +549,14 @@ std::string Engine::to_string(const std::string& indent) const
 
 double Engine::pitch2toneperiod(double pitch) const
 {
-	// We need to divide coef1 by 16.0, as explained in
-	// http://ym2149.com/ym2149.pdf page 5.
-	const double coef1 = (clock_rate / lower_note_freq) / 16.0;
-	static const double coef2 = log(2.0) / 12.0;
-	double pym = coef1 * exp(-pitch * coef2);
 	if (_zynayumi.patch.tone.legacy_tuning)
-		pym = std::round(pym);
-	return pym;
+		return _tone_period_table.rounded_period(pitch);
+	return _tone_period_table.period(pitch);
 }
 
 int Engine::pitch2envperiod(double pitch) const
 {
-	// We need to divide coef1 by 256.0, as explained in
-	// http://ym2149.com/ym2149.pdf page 7.
-	const double coef1 = (clock_rate / lower_note_freq) / 256.0;
-	static const double coef2 = log(2.0) / 12.0;
-	double pym = coef1 * exp(-pitch * coef2);
-	return std::lround(pym);
+	return _env_period_table.rounded_period(pitch);
 }
 
 double Engine::freq2pitch(double freq) const
@@ -445,26 +575,199 @@ double Engine::smp2sec(unsigned long long smp_count) const
 	return (double)smp_count / (double)sample_rate;
 }
 
+double Engine::chip_step() const
+{
+	return chips[0].ay.step * DECIMATE_FACTOR * _oversampling;
+}
+
 float Engine::vol2gain(short value)
 {
 	return ((float)value*(float)value) / (127.0f*127.0f);
 }
 
-int Engine::select_ym_channel(bool poly, unsigned char channel) const
+void Engine::resize_chips()
+{
+	_chip_count = std::clamp(_chip_count, 1, MAX_CHIPS);
+
+	// Remove the voices, then the chips, beyond _chip_count
+	while (_chip_count < (int)chips.size()) {
+		for (int c = 0; c < Chip::CHANNEL_COUNT; c++)
+			_voices.pop_back();
+		chips.pop_back();
+	}
+
+	// Add chips and their voices, enabled according to the patch
+	while ((int)chips.size() < _chip_count) {
+		chips.emplace_back(chips.size());
+		for (int c = 0; c < Chip::CHANNEL_COUNT; c++) {
+			_voices.emplace_back(*this, _zynayumi.patch, chips.back(), c);
+			if (not _zynayumi.patch.mixer.enabled[c])
+				_voices.back().disable();
+		}
+	}
+}
+
+bool Engine::is_idle() const
+{
+	if (register_player)
+		return false;
+	for (const Voice& v : _voices)
+		if (not v.is_silent())
+			return false;
+	for (const Chip& chip : chips)
+		if (not chip.is_idle())
+			return false;
+	return true;
+}
+
+void Engine::configure_smoothers()
+{
+	for (Smoother& smoother : _smoothers)
+		smoother.configure(_smoothing_mode, _smoothing_time, sample_rate);
+}
+
+double Engine::get_smoothed_target(Smoothed s) const
+{
+	const Patch& patch = _zynayumi.patch;
+	switch(s) {
+	case Smoothed::Gain:
+		return patch.mixer.gain;
+	case Smoothed::Pan0:
+		return patch.mixer.pan[0];
+	case Smoothed::Pan1:
+		return patch.mixer.pan[1];
+	case Smoothed::Pan2:
+		return patch.mixer.pan[2];
+	case Smoothed::ToneDetune:
+		return patch.tone.detune;
+	case Smoothed::LfoDepth:
+		return patch.lfo.depth;
+	default:
+		return 0.0;
+	}
+}
+
+void Engine::smooth(int count)
+{
+	for (int s = 0; s < (int)Smoothed::Count; s++)
+		_smoothers[s].process(get_smoothed_target((Smoothed)s),
+		                      _smoothed[s], count);
+}
+
+uint32_t Engine::random()
+{
+	// Xorshift
+	_random_state ^= _random_state << 13;
+	_random_state ^= _random_state >> 17;
+	_random_state ^= _random_state << 5;
+	return _random_state;
+}
+
+template<typename T>
+void Engine::render_block(Renderer<T>& renderer,
+                          float* left_out, float* right_out, int count)
+{
+	// Run the chips. The first one goes first as its voices keep track
+	// of the last pitch, read by the voices of the other chips, which
+	// are then independent and can be run in parallel.
+	render_chip(0, count);
+	if (0 < _worker_pool.size()) {
+		ChipJob job{this, count};
+		_worker_pool.run(render_chip_task, &job, chips.size() - 1);
+	} else {
+		for (unsigned k = 1; k < chips.size(); k++)
+			render_chip(k, count);
+	}
+
+	// Sum the chips
+	const int size = count * _oversampling;
+	std::copy(chips[0].left, chips[0].left + size, renderer.chip_left);
+	std::copy(chips[0].right, chips[0].right + size, renderer.chip_right);
+	for (unsigned k = 1; k < chips.size(); k++) {
+		const Chip& chip = chips[k];
+		for (int n = 0; n < size; n++) {
+			renderer.chip_left[n] += chip.left[n];
+			renderer.chip_right[n] += chip.right[n];
+		}
+	}
+
+	// Decimate to the host sample rate and remove DC
+	renderer.process(count);
+
+	// Update outputs, ramping the gain
+	const double* gain = _smoothed[(int)Smoothed::Gain];
+	for (int i = 0; i < count; i++) {
+		left_out[i] = (float)renderer.block_left[i] * (1.0f - pan) *
+			(float)gain[i] * volume_gain * expression_gain;
+		right_out[i] = (float)renderer.block_right[i] * pan *
+			(float)gain[i] * volume_gain * expression_gain;
+	}
+}
+
+void Engine::render_chip(unsigned chip_index, int count)
+{
+	// Voices are updated every sample as they modulate the registers
+	Chip& chip = chips[chip_index];
+	Voice* voices = &_voices[chip_index * Chip::CHANNEL_COUNT];
+	double* cl = chip.left;
+	double* cr = chip.right;
+	const bool update_voices = not register_player;
+	for (int i = 0; i < count; i++) {
+		if (update_voices)
+			for (int c = 0; c < Chip::CHANNEL_COUNT; c++)
+				voices[c].update(i);
+		for (int j = 0; j < _oversampling; j++) {
+			ayumi_process(&chip.ay);
+			*cl++ = chip.ay.left;
+			*cr++ = chip.ay.right;
+		}
+	}
+}
+
+void Engine::render_chip_task(void* context, int index)
+{
+	ChipJob* job = static_cast<ChipJob*>(context);
+	job->engine->render_chip(index + 1, job->count);
+}
+
+void Engine::configure_ayumi()
+{
+	_oversampling = std::clamp(_oversampling, 1, DecimatorBase::MAX_FACTOR);
+	for (Chip& chip : chips)
+		chip.configure(emulmode == EmulMode::YM2149, clock_rate,
+		               sample_rate * _oversampling);
+	_double_renderer.configure(_oversampling);
+	_single_renderer.configure(_oversampling);
+
+	// We need to divide by 16.0 and 256.0, as explained in
+	// http://ym2149.com/ym2149.pdf page 5 and 7.
+	_tone_period_table.configure((clock_rate / lower_note_freq) / 16.0);
+	_env_period_table.configure((clock_rate / lower_note_freq) / 256.0);
+
+	for (Voice& v : _voices)
+		v.refresh();
+	if (register_player)
+		register_player->refresh();
+
+	// The filters are cleared and ayumi restarted
+	_idle_frames = 0;
+}
+
+int Engine::select_ym_channel(bool poly, unsigned char channel)
 {
-	std::set<unsigned char> valid_ym_channels = get_valid_ym_channels(channel);
+	ChannelMask valid_ym_channels = get_valid_ym_channels(channel);
 
 	// No available ym channel, selection failed.
 	if (valid_ym_channels.empty())
 		return -1;
 
 	// Not polyphonic, return the first enabled one
-	unsigned char first_enabled_ym_channel = *valid_ym_channels.begin();
+	unsigned char first_enabled_ym_channel = valid_ym_channels[0];
 	if (not poly)
 		return first_enabled_ym_channel;
 
 	// Determine silent ym channels for poly selection
-	std::set<unsigned char> silent_channels;
+	ChannelMask silent_channels;
 	for (unsigned char ymch : valid_ym_channels)
 		if (_voices[ymch].is_silent())
 			silent_channels.insert(ymch);
@@ -491,8 +794,8 @@ int Engine::select_ym_channel(bool poly, unsigned char channel) const
 		return least_significant_channel;
 	} else {
 		// Otherwise select randomly among the silent ones
-		int rchi = rand() % silent_channels.size(); // NEXT: replace rand() by Voice::hash
-		return *std::next(silent_channels.begin(), rchi);
+		int rchi = random() % silent_channels.size();
+		return silent_channels[rchi];
 	}
 }
 
@@ -538,13 +841,14 @@ bool Engine::is_valid_midi_channel(Control::MidiChannel midi_ch, unsigned char c
 	}
 }
 
-std::set<unsigned char> Engine::get_valid_ym_channels(unsigned char channel) const
+ChannelMask Engine::get_valid_ym_channels(unsigned char channel) const
 {
-	std::set<unsigned char> valid_ym_channels;
-	for (const Voice& v : _voices) {
+	ChannelMask valid_ym_channels;
+	for (unsigned i = 0; i < _voices.size(); i++) {
+		const Voice& v = _voices[i];
 		Control::MidiChannel midi_ch = _zynayumi.patch.control.midi_ch[v.ym_channel];
 		if (v.enabled and is_valid_midi_channel(midi_ch, channel)) {
-			valid_ym_channels.insert((unsigned char)v.ym_channel);
+			valid_ym_channels.insert((unsigned char)i);
 		}
 	}
 	return valid_ym_channels;
@@ -619,15 +923,16 @@ void Engine::insert_pitch(unsigned char channel,
                           unsigned char pitch,
                           unsigned char velocity)
 {
-	pitches.insert(pitch);
-	pitch_stack.push_back(pitch);
+	// Once pitches is full the pitch is ignored by both, so that they
+	// keep holding the same pitches
+	if (pitches.insert(pitch))
+		pitch_stack.push_back(pitch);
 }
 
 void Engine::erase_pitch(unsigned char channel, unsigned char pitch)
 {
-	auto range = pitches.equal_range(pitch);
-	pitches.erase(range.first, range.second);
-	boost::remove_erase(pitch_stack, pitch);
+	pitches.erase(pitch);
+	pitch_stack.remove(pitch);
 }
 
 void Engine::insert_sustain_pitch(unsigned char pitch)
@@ -635,11 +940,9 @@ void Engine::insert_sustain_pitch(unsigned char pitch)
 	sustain_pitches.insert(pitch);
 }
 
-std::multiset<unsigned char>::iterator
-Engine::erase_sustain_pitch(unsigned char pitch)
+void Engine::erase_sustain_pitch(unsigned char pitch)
 {
-	auto range = sustain_pitches.equal_range(pitch);
-	return sustain_pitches.erase(range.first, range.second);
+	sustain_pitches.erase(pitch);
 }
 
 } // ~namespace zynayumi
@@ -27,20 +27,45 @@
 
 #include <cmath>
 #include <map>
-#include <set>
 #include <vector>
 #include <cstdlib>
 
+#include "chip.hpp"
 #include "voice.hpp"
-
-extern "C"
-{
-#include "../../ayumi/ayumi.h"
-}
+#include "renderer.hpp"
+#include "diagnostics.hpp"
+#include "notes.hpp"
+#include "pitchtable.hpp"
+#include "smoother.hpp"
+#include "workerpool.hpp"
 
 namespace zynayumi {
 
 class Zynayumi;
+class RegisterCapture;
+class RegisterPlayer;
+
+/**
+ * Settings of the engine exposed as parameters, kept apart so that
+ * their offsets are well defined and parameters can locate them.
+ */
+struct EngineSettings {
+	// Oversampling, how many times faster than the host sample rate
+	// ayumi runs before being decimated
+	int oversampling;
+
+	// Number of samples between two updates of the voice modulators
+	// (envelopes, LFO, portamento, etc). 1 means every sample.
+	int control_period;
+
+	// Number of emulated chips, within [1, Engine::MAX_CHIPS]. Voices
+	// are allocated across the YM channels of all chips.
+	int chip_count;
+
+	// Ramps of the smoothed parameters, and their time in second
+	SmoothingMode smoothing_mode;
+	float smoothing_time;
+};
 
 /**
  * The engine holds the information of each voice, state of the
@@ -55,7 +80,7 @@ class Zynayumi;
  * channel.
  */
 
-class Engine {
+class Engine : public EngineSettings {
 public:
 
 	/////////////////
@@ -65,12 +90,38 @@ public:
 	static const int YM2149_CLOCK_RATE = 2000000;
 	static const int AY8910_CLOCK_RATE = 1000000;
 
+	// Maximum number of frames rendered at once by render_block
+	static const int BLOCK_SIZE = DecimatorBase::MAX_BLOCK_SIZE;
+
+	// Maximum number of emulated chips, each adding three voices
+	static const int MAX_CHIPS = 8;
+
+	// Number of frames after which the filters have settled once the
+	// chips are idle, covering the FIR of ayumi, the decimator and the
+	// DC filter
+	static const int SILENCE_DELAY = FIR_SIZE + DecimatorBase::MAX_TAPS
+		+ Renderer<double>::DC_FILTER_SIZE;
+
+	// Continuous parameters of the patch ramped toward their values
+	// inside the render loop, so that their automation does not cause
+	// zipper noise
+	enum class Smoothed {
+		Gain,
+		Pan0,
+		Pan1,
+		Pan2,
+		ToneDetune,                // Including the transposition
+		LfoDepth,
+
+		Count
+	};
+
 	///////////////////
 	// Attributes    //
 	///////////////////
 
-	// Current ayumi state
-	ayumi ay;
+	// Emulated chips in use, mixed together
+	std::vector<Chip> chips;
 
 	// Current emulation mode (YM2149 or AY8910)
 	EmulMode emulmode;
@@ -81,23 +132,14 @@ public:
 	// Current play mode
 	PlayMode playmode;
 
-	// Current buzzer shape
-	Buzzer::Shape buzzershape;
-
-	// Current ringmod loop
-	RingMod::Loop ringmodloop;
-
-	// Current ayumi envelope shape
-	int ayenvshape;
-
 	// Current pitches. Useful for handling chord based arp.
-	std::multiset<unsigned char> pitches;
+	PitchSet pitches;
 
 	// Stack of pitches for mono and unison mode.
-	std::vector<unsigned char> pitch_stack;
+	PitchStack pitch_stack;
 
 	// Pitches hold by the sustain pedal
-	std::multiset<unsigned char> sustain_pitches;
+	PitchSet sustain_pitches;
 
 	// Keep track of the previous pitch for portamento. Negative means
 	// none.
@@ -130,8 +172,23 @@ public:
 	// True iff the sustain pedal is on
 	bool sustain_pedal;
 
-	// Oversampling
-	int oversampling;
+	// Precision of the decimation and DC removal, by default single
+	// if built with ZYNAYUMI_SINGLE_PRECISION, double otherwise.
+	Precision precision;
+
+	// Diagnostic messages emitted during processing, to be drained by
+	// a non real-time thread
+	Diagnostics diagnostics;
+
+	// Capture of the chip registers, if any, not owned. Not real-time
+	// safe, meant for offline renders.
+	RegisterCapture* register_capture;
+
+	// Player of a register stream, if any, not owned. When set, the
+	// chips, their type, clock rate and count, follow the stream, and
+	// are driven by it instead of the voices. The settings, chip_count
+	// in particular, are left untouched and apply again once cleared.
+	RegisterPlayer* register_player;
 
 	/////////////////////////////////
 	// Constructors/descructors    //
@@ -149,14 +206,32 @@ public:
 	// Set bpm
 	void set_bpm(double bpm);
 
-	// Process audio.
+	// Set/get the number of worker threads rendering chips in parallel
+	// with the audio thread, 0 meaning that all chips are rendered by
+	// the audio thread. Workers are pinned to the CPUs listed in cpus,
+	// see WorkerPool::start, which should exclude the CPU of the audio
+	// thread as only the host knows it. If cpus is empty, workers are
+	// not pinned. Not real-time safe, must not be called during audio
+	// processing.
+	void set_worker_count(int count, const std::vector<int>& cpus = {});
+	int get_worker_count() const;
+
+	// Process audio. Once every voice is silent and the filters have
+	// settled the chips are not run anymore and the buffers are filled
+	// with zeros. Return true iff that is the case of the whole
+	// buffers, so that the host can skip processing them.
 	//
 	// Assumptions:
 	//
-	// 1. The parameters do not change during audio processing
+	// 1. The parameters do not change during a call. Changes posted to
+	//    Zynayumi::parameter_queue are applied in frame order between
+	//    calls, Zynayumi::audio_process splitting its block at the
+	//    frame of each of them. Setting a value directly, with
+	//    Parameters::set_value for instance, from another thread
+	//    during audio processing is not supported.
 	//
 	// 2. All processing is added to the buffers
-	void audio_process(float* left_out, float* right_out,
+	bool audio_process(float* left_out, float* right_out,
 	                   unsigned long sample_count);
 
 	// Process MIDI events
@@ -184,18 +259,76 @@ public:
 	double freq2pitch(double freq) const;
 	double smp2sec(unsigned long long smp_count) const;
 
+	// Number of ayumi steps (in chip clock / 8 unit) per host sample,
+	// taking into account oversampling.
+	double chip_step() const;
+
 	static float vol2gain(short value);
 
+	// Return the value of a smoothed parameter at frame, within the
+	// block being rendered.
+	double get_smoothed(Smoothed s, int frame) const;
+
+	// Return a pseudo random number. The generator is private to the
+	// engine so that renders are reproducible and independent of
+	// other instances.
+	uint32_t random();
+
 private:
-	int select_ym_channel(bool poly, unsigned char channel) const;
+	// (Re)configure ayumi according to the emulation mode, clock
+	// rate, sample rate and oversampling, and rebuild the period
+	// tables. Voices re-apply their registers on their next update.
+	void configure_ayumi();
+
+	// Add or remove chips, and their voices, to reach _chip_count
+	void resize_chips();
+
+	// Set the ramps of the smoothers according to the smoothing mode
+	// and time, and the sample rate
+	void configure_smoothers();
+
+	// Return the value of the patch a smoothed parameter ramps to
+	double get_smoothed_target(Smoothed s) const;
+
+	// Ramp the smoothed parameters toward the patch over count frames,
+	// at most BLOCK_SIZE, from the start of the block
+	void smooth(int count);
+
+	// True iff every voice is silent and every chip idle, and no
+	// register stream is played, so that the chips output a constant
+	bool is_idle() const;
+
+	// Render count frames, at most BLOCK_SIZE, in stages over
+	// contiguous buffers. Each chip is run along the updates of its
+	// voices, then the chips are summed into the buffers of renderer,
+	// decimated, DC filtered and mixed.
+	template<typename T>
+	void render_block(Renderer<T>& renderer,
+	                  float* left_out, float* right_out, int count);
+
+	// Run a chip over count frames, at most BLOCK_SIZE, into its
+	// buffers, updating its voices every frame. Voices only modulate
+	// their own chip so that chips can be run independently.
+	void render_chip(unsigned chip_index, int count);
+
+	// Task of _worker_pool rendering the chip index + 1, context
+	// pointing to a ChipJob
+	struct ChipJob {
+		Engine* engine;
+		int count;
+	};
+	static void render_chip_task(void* context, int index);
+
+	int select_ym_channel(bool poly, unsigned char channel);
 
 	// Return true iff the input midi channel in MIDI format matches
 	// the midi channel in Control::MidiChannel format.
 	bool is_valid_midi_channel(Control::MidiChannel midi_ch, unsigned char channel) const;
 
-	// Return the set of YM channels that are both enabled and accept
-	// the input channel.
-	std::set<unsigned char> get_valid_ym_channels(unsigned char channel) const;
+	// Return the set of YM channels, across all chips, that are both
+	// enabled and accept the input channel. Each YM channel is the
+	// index of its voice.
+	ChannelMask get_valid_ym_channels(unsigned char channel) const;
 	void set_last_pitch(unsigned char pitch);
 	void add_voice(unsigned char channel, unsigned char pitch, unsigned char velocity);
 	void add_all_voices(unsigned char channel, unsigned char pitch, unsigned char velocity);
@@ -207,15 +340,64 @@ private:
 	void insert_pitch(unsigned char channel, unsigned char pitch, unsigned char vel);
 	void erase_pitch(unsigned char channel, unsigned char pitch);
 	void insert_sustain_pitch(unsigned char pitch);
-	std::multiset<unsigned char>::iterator erase_sustain_pitch(unsigned char pitch);
+	void erase_sustain_pitch(unsigned char pitch);
 
 	const Zynayumi& _zynayumi;
 
-	// Vector of voices, one per ym channel
+	// Vector of voices, one per ym channel of each chip. The voices
+	// of chip k are at indices 3k to 3k+2. Both chips and _voices have
+	// their capacities reserved for MAX_CHIPS, so that resizing them
+	// never allocates nor moves them.
 	typedef std::vector<Voice> Voices;
 	Voices _voices;
+
+	// Number of chips currently in use, chip_count or the number of
+	// chips of the register stream being played
+	int _chip_count;
+
+	// State of the pseudo random number generator
+	uint32_t _random_state;
+
+	// Workers rendering chips in parallel
+	WorkerPool _worker_pool;
+
+	// Oversampling currently in use by ayumi and the decimator
+	int _oversampling;
+
+	// Number of frames rendered since the chips became idle, up to
+	// SILENCE_DELAY
+	int _idle_frames;
+
+	// Precision currently in use
+	Precision _precision;
+
+	// Smoothing currently in use
+	SmoothingMode _smoothing_mode;
+	float _smoothing_time;
+
+	// Smoothers of the parameters, whether they have been reset to
+	// the patch yet, and their values over the block being rendered
+	Smoother _smoothers[(int)Smoothed::Count];
+	bool _smoothers_reset;
+	double _smoothed[(int)Smoothed::Count][BLOCK_SIZE];
+
+	// Post processing of the chip output in double and single
+	// precision, only the one of _precision is in use.
+	Renderer<double> _double_renderer;
+	Renderer<float> _single_renderer;
+
+	// Pitch to tone and envelope period tables, depending on the
+	// clock rate
+	PitchTable _tone_period_table;
+	PitchTable _env_period_table;
 };
 
+// Defined inline as it is called for every voice at control rate
+inline double Engine::get_smoothed(Smoothed s, int frame) const
+{
+	return _smoothed[(int)s][frame];
+}
+
 } // ~namespace zynayumi
 
 #endif
@@ -0,0 +1,285 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    midifile.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+#include "midifile.hpp"
+
+using namespace zynayumi;
+
+namespace {
+
+// Default tempo, in microsecond per quarter note, 120 BPM
+const uint32_t DEFAULT_TEMPO = 500000;
+
+// Channel or tempo event, timed in ticks
+struct TickEvent {
+	uint64_t tick;
+	uint32_t tempo;             // Tempo of tempo events, 0 otherwise
+	unsigned size;
+	unsigned char data[3];
+};
+
+// Reader of big endian integers and variable length quantities over
+// a bounded buffer. Reading past the end sets the failure flag.
+class Reader {
+public:
+	Reader(const unsigned char* begin, const unsigned char* end)
+		: _p(begin), _end(end), _failed(false) {}
+
+	bool at_end() const { return _end <= _p or _failed; }
+	size_t remaining() const { return _end - _p; }
+	bool failed() const { return _failed; }
+	const unsigned char* position() const { return _p; }
+
+	uint32_t u8()
+	{
+		if (_end <= _p) {
+			_failed = true;
+			return 0;
+		}
+		return *_p++;
+	}
+
+	uint32_t u16()
+	{
+		uint32_t v = u8() << 8;
+		return v | u8();
+	}
+
+	uint32_t u32()
+	{
+		uint32_t v = u16() << 16;
+		return v | u16();
+	}
+
+	uint32_t vlq()
+	{
+		uint32_t v = 0;
+		for (int i = 0; i < 4; i++) {
+			uint32_t b = u8();
+			v = (v << 7) | (b & 0x7f);
+			if (not (b & 0x80))
+				return v;
+		}
+		_failed = true;
+		return v;
+	}
+
+	void skip(uint32_t n)
+	{
+		if ((uint32_t)(_end - _p) < n) {
+			_failed = true;
+			_p = _end;
+		} else {
+			_p += n;
+		}
+	}
+
+	bool tag(const char* t)
+	{
+		if (_end - _p < 4 or not std::equal(t, t + 4, _p)) {
+			_failed = true;
+			return false;
+		}
+		_p += 4;
+		return true;
+	}
+
+private:
+	const unsigned char* _p;
+	const unsigned char* _end;
+	bool _failed;
+};
+
+// Number of data bytes of a channel message given its status
+unsigned data_size(unsigned char status)
+{
+	switch (status & 0xf0) {
+	case 0xc0:                  // Program change
+	case 0xd0:                  // Channel pressure
+		return 1;
+	default:
+		return 2;
+	}
+}
+
+// Parse a track into events, return false on failure
+bool parse_track(Reader& reader, std::vector<TickEvent>& events)
+{
+	uint64_t tick = 0;
+	unsigned char running = 0;
+	while (not reader.at_end()) {
+		tick += reader.vlq();
+		unsigned char status = reader.u8();
+		if (status == 0xff) {
+			// Meta event
+			unsigned char type = reader.u8();
+			uint32_t length = reader.vlq();
+			if (type == 0x51 and length == 3) {
+				uint32_t tempo = reader.u8() << 16;
+				tempo |= reader.u16();
+				events.push_back({tick, std::max<uint32_t>(tempo, 1), 0, {0, 0, 0}});
+			} else if (type == 0x2f) {
+				// End of track
+				reader.skip(length);
+				break;
+			} else {
+				reader.skip(length);
+			}
+		} else if (status == 0xf0 or status == 0xf7) {
+			// System exclusive
+			reader.skip(reader.vlq());
+		} else {
+			TickEvent event{tick, 0, 0, {0, 0, 0}};
+			if (status & 0x80) {
+				running = status;
+				event.data[event.size++] = status;
+			} else if (running) {
+				// Running status, status is the first data byte
+				event.data[event.size++] = running;
+				event.data[event.size++] = status;
+			} else {
+				return false;
+			}
+			while (event.size < 1 + data_size(running))
+				event.data[event.size++] = reader.u8();
+			events.push_back(event);
+		}
+	}
+	return not reader.failed();
+}
+
+} // ~namespace
+
+MidiFile::MidiFile() {}
+
+bool MidiFile::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (not file)
+		return false;
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+	                                std::istreambuf_iterator<char>());
+	return parse(data.data(), data.size());
+}
+
+bool MidiFile::parse(const unsigned char* data, size_t size)
+{
+	_events.clear();
+	Reader reader(data, data + size);
+
+	// Header
+	if (not reader.tag("MThd"))
+		return false;
+	uint32_t header_size = reader.u32();
+	uint32_t format = reader.u16();
+	uint32_t track_count = reader.u16();
+	uint32_t division = reader.u16();
+	reader.skip(header_size - std::min<uint32_t>(header_size, 6));
+	if (reader.failed() or 1 < format or division == 0)
+		return false;
+
+	// SMPTE division, frames per second, 29 standing for 29.97 drop
+	// frame, and ticks per frame
+	bool smpte = division & 0x8000;
+	int fps = -(int8_t)(division >> 8);
+	int ticks_per_frame = division & 0xff;
+	if (smpte and ((fps != 24 and fps != 25 and fps != 29 and fps != 30)
+	               or ticks_per_frame == 0))
+		return false;
+
+	// Tracks, unknown chunks are skipped
+	std::vector<TickEvent> events;
+	for (uint32_t t = 0; t < track_count and not reader.at_end();) {
+		if (reader.remaining() < 8)
+			return false;
+		bool is_track = std::equal(reader.position(), reader.position() + 4,
+		                           "MTrk");
+		reader.skip(4);
+		uint32_t length = reader.u32();
+		const unsigned char* begin = reader.position();
+		reader.skip(length);
+		if (reader.failed())
+			return false;
+		if (is_track) {
+			Reader track(begin, begin + length);
+			if (not parse_track(track, events))
+				return false;
+			t++;
+		}
+	}
+
+	// Merge the tracks, keeping the order of simultaneous events
+	std::stable_sort(events.begin(), events.end(),
+	                 [](const TickEvent& a, const TickEvent& b) {
+		                 return a.tick < b.tick;
+	                 });
+
+	// Convert ticks to seconds, following the tempo map if the
+	// division is in ticks per quarter note, or SMPTE frames
+	double time = 0.0;
+	uint64_t last_tick = 0;
+	double seconds_per_tick;
+	if (smpte) {
+		seconds_per_tick = 1.0 / ((fps == 29 ? 29.97 : fps) * ticks_per_frame);
+	} else {
+		seconds_per_tick = DEFAULT_TEMPO * 1e-6 / division;
+	}
+	for (const TickEvent& e : events) {
+		time += (e.tick - last_tick) * seconds_per_tick;
+		last_tick = e.tick;
+		if (e.tempo) {
+			if (not smpte)
+				seconds_per_tick = e.tempo * 1e-6 / division;
+		} else {
+			_events.push_back({time, e.size, {e.data[0], e.data[1], e.data[2]}});
+		}
+	}
+	return true;
+}
+
+const std::vector<MidiFile::Event>& MidiFile::get_events() const
+{
+	return _events;
+}
+
+double MidiFile::get_duration() const
+{
+	return _events.empty() ? 0.0 : _events.back().time;
+}
+
+std::vector<MidiEvent> MidiFile::to_midi_events(int sample_rate) const
+{
+	std::vector<MidiEvent> events;
+	events.reserve(_events.size());
+	for (const Event& e : _events)
+		events.push_back({(unsigned long)std::lround(e.time * sample_rate),
+		                  e.size, {e.data[0], e.data[1], e.data[2]}});
+	return events;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    midifile.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_MIDIFILE_HPP
+#define __ZYNAYUMI_MIDIFILE_HPP
+
+#include <string>
+#include <vector>
+
+#include "zynayumi.hpp"
+
+namespace zynayumi {
+
+/**
+ * Channel events of a Standard MIDI File, format 0 or 1, merged
+ * across tracks and timed in seconds according to its tempo map.
+ * Meta events other than tempo changes and system exclusive events
+ * are skipped.
+ */
+class MidiFile {
+public:
+
+	// Channel event with its time in second
+	struct Event {
+		double time;
+		unsigned size;
+		unsigned char data[3];
+	};
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	MidiFile();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Load and parse a file. Return false if it cannot be read or is
+	// not a valid Standard MIDI File.
+	bool load(const std::string& path);
+
+	// Parse the content of a file. Return false if it is not a valid
+	// Standard MIDI File.
+	bool parse(const unsigned char* data, size_t size);
+
+	// Events sorted by time
+	const std::vector<Event>& get_events() const;
+
+	// Time of the last event in second
+	double get_duration() const;
+
+	// Events with their absolute frames at sample_rate
+	std::vector<MidiEvent> to_midi_events(int sample_rate) const;
+
+private:
+	std::vector<Event> _events;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -0,0 +1,202 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    notes.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#include <algorithm>
+#include <iterator>
+
+#include "notes.hpp"
+
+using namespace zynayumi;
+
+PitchSet::PitchSet()
+{
+	clear();
+}
+
+bool PitchSet::insert(unsigned char pitch)
+{
+	if (_size == CAPACITY)
+		return false;
+	pitch &= PITCH_COUNT - 1;
+	_counts[pitch]++;
+
+	// Insert after the existing occurrences
+	unsigned char* last = _sorted + _size;
+	unsigned char* pos = std::upper_bound(_sorted, last, pitch);
+	std::copy_backward(pos, last, last + 1);
+	*pos = pitch;
+	_size++;
+	return true;
+}
+
+unsigned PitchSet::erase(unsigned char pitch)
+{
+	pitch &= PITCH_COUNT - 1;
+	unsigned c = _counts[pitch];
+	if (c == 0)
+		return 0;
+	_counts[pitch] = 0;
+
+	unsigned char* last = _sorted + _size;
+	unsigned char* pos = std::lower_bound(_sorted, last, pitch);
+	std::copy(pos + c, last, pos);
+	_size -= c;
+	return c;
+}
+
+void PitchSet::clear()
+{
+	std::fill(std::begin(_counts), std::end(_counts), 0);
+	_size = 0;
+}
+
+unsigned PitchSet::count(unsigned char pitch) const
+{
+	return _counts[pitch & (PITCH_COUNT - 1)];
+}
+
+unsigned PitchSet::size() const
+{
+	return _size;
+}
+
+bool PitchSet::empty() const
+{
+	return _size == 0;
+}
+
+unsigned char PitchSet::min() const
+{
+	return (*this)[0];
+}
+
+unsigned char PitchSet::operator[](unsigned index) const
+{
+	return _sorted[index];
+}
+
+PitchStack::PitchStack() : _size(0) {}
+
+void PitchStack::push_back(unsigned char pitch)
+{
+	if (_size == CAPACITY) {
+		std::copy(_pitches + 1, _pitches + CAPACITY, _pitches);
+		_size--;
+	}
+	_pitches[_size++] = pitch;
+}
+
+void PitchStack::remove(unsigned char pitch)
+{
+	_size = std::remove(_pitches, _pitches + _size, pitch) - _pitches;
+}
+
+void PitchStack::clear()
+{
+	_size = 0;
+}
+
+unsigned PitchStack::size() const
+{
+	return _size;
+}
+
+bool PitchStack::empty() const
+{
+	return _size == 0;
+}
+
+unsigned char PitchStack::back() const
+{
+	return _pitches[_size - 1];
+}
+
+const unsigned char* PitchStack::begin() const
+{
+	return _pitches;
+}
+
+const unsigned char* PitchStack::end() const
+{
+	return _pitches + _size;
+}
+
+ChannelMask::const_iterator::const_iterator(uint32_t bits) : _bits(bits) {}
+
+unsigned char ChannelMask::const_iterator::operator*() const
+{
+	return __builtin_ctz(_bits);
+}
+
+ChannelMask::const_iterator& ChannelMask::const_iterator::operator++()
+{
+	_bits &= _bits - 1;
+	return *this;
+}
+
+bool ChannelMask::const_iterator::operator!=(const const_iterator& other) const
+{
+	return _bits != other._bits;
+}
+
+ChannelMask::ChannelMask() : _bits(0) {}
+
+void ChannelMask::insert(unsigned char ym_channel)
+{
+	_bits |= (uint32_t)1 << ym_channel;
+}
+
+bool ChannelMask::contains(unsigned char ym_channel) const
+{
+	return _bits & ((uint32_t)1 << ym_channel);
+}
+
+unsigned ChannelMask::size() const
+{
+	return __builtin_popcount(_bits);
+}
+
+bool ChannelMask::empty() const
+{
+	return _bits == 0;
+}
+
+unsigned char ChannelMask::operator[](unsigned index) const
+{
+	uint32_t bits = _bits;
+	for (; index; index--)
+		bits &= bits - 1;
+	return __builtin_ctz(bits);
+}
+
+ChannelMask::const_iterator ChannelMask::begin() const
+{
+	return const_iterator(_bits);
+}
+
+ChannelMask::const_iterator ChannelMask::end() const
+{
+	return const_iterator(0);
+}
@@ -0,0 +1,193 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    notes.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#ifndef __ZYNAYUMI_NOTES_HPP
+#define __ZYNAYUMI_NOTES_HPP
+
+#include <cstdint>
+
+namespace zynayumi {
+
+/**
+ * Multiset of MIDI pitches of fixed capacity, represented by the
+ * multiplicity of each pitch. Never allocates.
+ *
+ * A sorted array of the pitches, including repeated occurrences, is
+ * maintained incrementally on insert and erase so that accessing the
+ * index-th smallest pitch, as done by the arpeggiator, is a single
+ * load.
+ */
+class PitchSet {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const unsigned PITCH_COUNT = 128;
+
+	// Maximum number of pitches, including repeated occurrences.
+	// Insertions beyond are ignored.
+	static const unsigned CAPACITY = 256;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	PitchSet();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Insert one occurrence of pitch. Return false if the set is full.
+	bool insert(unsigned char pitch);
+
+	// Erase all occurrences of pitch, return the number of erased
+	// occurrences.
+	unsigned erase(unsigned char pitch);
+
+	void clear();
+
+	// Number of occurrences of pitch
+	unsigned count(unsigned char pitch) const;
+
+	// Number of pitches, including repeated occurrences
+	unsigned size() const;
+	bool empty() const;
+
+	// Return the smallest pitch. Undefined if empty.
+	unsigned char min() const;
+
+	// Return the index-th smallest pitch, accounting for repeated
+	// occurrences, like the index-th element of a sorted multiset.
+	// Undefined if index >= size().
+	unsigned char operator[](unsigned index) const;
+
+private:
+	uint16_t _counts[PITCH_COUNT];
+	unsigned _size;
+
+	// Pitches in increasing order, the first _size are valid
+	unsigned char _sorted[CAPACITY];
+};
+
+/**
+ * Stack of MIDI pitches of fixed capacity. When full, pushing a pitch
+ * discards the bottom of the stack, i.e. the oldest pitch.
+ */
+class PitchStack {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const unsigned CAPACITY = 256;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	PitchStack();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	void push_back(unsigned char pitch);
+
+	// Remove all occurrences of pitch
+	void remove(unsigned char pitch);
+
+	void clear();
+	unsigned size() const;
+	bool empty() const;
+
+	// Return the top of the stack. Undefined if empty.
+	unsigned char back() const;
+
+	// Iterate from bottom to top
+	const unsigned char* begin() const;
+	const unsigned char* end() const;
+
+private:
+	unsigned char _pitches[CAPACITY];
+	unsigned _size;
+};
+
+/**
+ * Set of YM channels, across all chips, represented as a bitmask.
+ */
+class ChannelMask {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Maximum number of channels
+	static const int CAPACITY = 32;
+
+	// Iterate over channels in increasing order
+	class const_iterator {
+	public:
+		const_iterator(uint32_t bits);
+		unsigned char operator*() const;
+		const_iterator& operator++();
+		bool operator!=(const const_iterator& other) const;
+	private:
+		uint32_t _bits;
+	};
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	ChannelMask();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	void insert(unsigned char ym_channel);
+	bool contains(unsigned char ym_channel) const;
+	unsigned size() const;
+	bool empty() const;
+
+	// Return the index-th smallest channel. Undefined if index >=
+	// size().
+	unsigned char operator[](unsigned index) const;
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	uint32_t _bits;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -0,0 +1,97 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    offline.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "offline.hpp"
+#include "parameters.hpp"
+#include "workstealingpool.hpp"
+
+namespace zynayumi {
+
+OfflineJob::OfflineJob()
+	: frame_count(0)
+	, sample_rate(44100)
+	, bpm(120)
+	, oversampling(Parameters::get_descriptor(OVERSAMPLING).dflt)
+	, control_period(Parameters::get_descriptor(CONTROL_PERIOD).dflt)
+	, chip_count(Parameters::get_descriptor(CHIP_COUNT).dflt)
+	, sink(nullptr)
+	, register_capture(nullptr)
+	, register_stream(nullptr)
+	, success(false)
+	, render_time(0.0)
+	, thread(-1)
+{
+}
+
+double OfflineJob::realtime_factor() const
+{
+	return 0.0 < render_time ?
+		(double)frame_count / sample_rate / render_time : 0.0;
+}
+
+namespace {
+
+void render_job(OfflineJob& job)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::unique_ptr<Zynayumi> zynayumi(new Zynayumi());
+	Engine& engine = zynayumi->engine;
+	engine.oversampling = job.oversampling;
+	engine.control_period = job.control_period;
+	engine.chip_count = job.chip_count;
+	zynayumi->set_sample_rate(job.sample_rate);
+	zynayumi->set_bpm(job.bpm);
+	engine.register_capture = job.register_capture;
+	std::unique_ptr<RegisterPlayer> player;
+	if (job.register_stream) {
+		player.reset(new RegisterPlayer(*job.register_stream));
+		engine.register_player = player.get();
+	}
+	job.success = job.sink
+		and zynayumi->render_offline(job.patch, job.events.data(),
+		                             job.events.size(), job.frame_count,
+		                             *job.sink);
+	job.render_time = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+}
+
+} // ~namespace
+
+bool render_offline(std::vector<OfflineJob>& jobs, int thread_count)
+{
+	WorkStealingPool pool(thread_count);
+	pool.run(jobs.size(), [&](size_t index, int thread) {
+		jobs[index].thread = thread;
+		render_job(jobs[index]);
+	});
+
+	return std::all_of(jobs.begin(), jobs.end(),
+	                   [](const OfflineJob& job) { return job.success; });
+}
+
+} // ~namespace zynayumi
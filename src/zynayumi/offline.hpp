@@ -0,0 +1,87 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    offline.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_OFFLINE_HPP
+#define __ZYNAYUMI_OFFLINE_HPP
+
+#include <vector>
+
+#include "zynayumi.hpp"
+#include "registerstream.hpp"
+
+namespace zynayumi {
+
+/**
+ * Offline render of a patch and MIDI events to a sink, independent
+ * of any other job, and its timing statistics.
+ */
+struct OfflineJob {
+	OfflineJob();
+
+	// Seconds of audio rendered per second of render_time
+	double realtime_factor() const;
+
+	Patch patch;
+
+	// Events with absolute frames, sorted
+	std::vector<MidiEvent> events;
+
+	// Number of frames to render
+	unsigned long frame_count;
+
+	// Engine settings
+	int sample_rate;
+	double bpm;
+	int oversampling;
+	int control_period;
+	int chip_count;
+
+	// Destination of the rendered frames, not owned
+	PcmSink* sink;
+
+	// Capture of the registers written during the render, if any, not
+	// owned
+	RegisterCapture* register_capture;
+
+	// Register stream played instead of the events, if any, not owned.
+	// Several jobs can share the same stream.
+	const RegisterStream* register_stream;
+
+	// Set by render_offline
+	bool success;               // Whether the job has been rendered
+	                            // successfully
+	double render_time;         // Wall clock time of the render, in
+	                            // second
+	int thread;                 // Index of the thread that rendered it
+};
+
+// Render the jobs concurrently, each on its own Zynayumi instance,
+// distributed over a work stealing pool of thread_count threads, all
+// cores if null. Not real-time safe. Return true iff all jobs
+// succeeded.
+bool render_offline(std::vector<OfflineJob>& jobs, int thread_count = 0);
+
+} // ~namespace zynayumi
+
+#endif
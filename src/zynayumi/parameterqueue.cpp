@@ -0,0 +1,79 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    parameterqueue.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#include "parameterqueue.hpp"
+
+using namespace zynayumi;
+
+void ParameterChange::apply() const
+{
+	if (normalized)
+		parameters->set_norm_value(index, value);
+	else
+		parameters->set_value(index, value);
+}
+
+ParameterQueue::ParameterQueue()
+	: _changes()
+	, _write(0)
+	, _read(0)
+	, _dropped(0)
+{
+}
+
+bool ParameterQueue::push(const ParameterChange& change)
+{
+	// Indices run freely, wrapping around, the buffer is full when
+	// they are CAPACITY apart.
+	unsigned write = _write.load(std::memory_order_relaxed);
+	if (write - _read.load(std::memory_order_acquire) == CAPACITY) {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	_changes[write & (CAPACITY - 1)] = change;
+	_write.store(write + 1, std::memory_order_release);
+	return true;
+}
+
+bool ParameterQueue::pop(ParameterChange& change)
+{
+	unsigned read = _read.load(std::memory_order_relaxed);
+	if (read == _write.load(std::memory_order_acquire))
+		return false;
+	change = _changes[read & (CAPACITY - 1)];
+	_read.store(read + 1, std::memory_order_release);
+	return true;
+}
+
+unsigned ParameterQueue::size() const
+{
+	return _write.load(std::memory_order_acquire)
+		- _read.load(std::memory_order_relaxed);
+}
+
+unsigned long ParameterQueue::dropped() const
+{
+	return _dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,108 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    parameterqueue.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#ifndef __ZYNAYUMI_PARAMETERQUEUE_HPP
+#define __ZYNAYUMI_PARAMETERQUEUE_HPP
+
+#include <atomic>
+
+#include "parameters.hpp"
+
+namespace zynayumi {
+
+/**
+ * Change of a parameter, posted by a control thread and applied by
+ * the audio thread.
+ */
+struct ParameterChange {
+	unsigned long frame;        // Frame offset within the audio block
+	Parameters* parameters;     // Parameters to change, not owned
+	ParameterIndex index;
+	float value;
+	bool normalized;            // Whether value is within [0, 1]
+
+	// Set the value, see Parameters::set_value and set_norm_value
+	void apply() const;
+};
+
+/**
+ * Lock-free single producer single consumer ring buffer of parameter
+ * changes.
+ *
+ * Changes are pushed by a single control thread, for instance the GUI
+ * or the thread of the host delivering automation, and popped by the
+ * audio thread, without locking or allocating. If the buffer is full
+ * the change is rejected and counted as dropped.
+ */
+class ParameterQueue {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Must be a power of 2
+	static const unsigned CAPACITY = 1024;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	ParameterQueue();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Push a change. Must only be called by a single producer thread.
+	// Return false if the change was dropped because the buffer is
+	// full.
+	bool push(const ParameterChange& change);
+
+	// Pop the oldest change. Must only be called by a single consumer
+	// thread. Return false if there is no change.
+	bool pop(ParameterChange& change);
+
+	// Number of changes waiting, as seen by the consumer
+	unsigned size() const;
+
+	// Number of dropped changes
+	unsigned long dropped() const;
+
+private:
+	ParameterChange _changes[CAPACITY];
+
+	// Next position to write, only modified by the producer
+	std::atomic<unsigned> _write;
+
+	// Next position to read, only modified by the consumer
+	std::atomic<unsigned> _read;
+
+	std::atomic<unsigned long> _dropped;
+};
+
+} // ~namespace zynayumi
+
+#endif
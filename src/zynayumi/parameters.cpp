@@ -24,10 +24,13 @@
 
 #include "parameters.hpp"
 
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <sstream>
-
-#include <boost/algorithm/string.hpp>
+#include <type_traits>
+#include <utility>
 
 #include "patch.hpp"
 #include "zynayumi.hpp"
@@ -45,747 +48,237 @@ float affine(float minx, float maxx, float miny, float maxy, float x)
 	return ((x - minx) / (maxx - minx)) * (maxy - miny) + miny;
 }
 
-Parameter::Parameter(const std::string& nm, const std::string& unt)
-	: name(nm), unit(unt)
-{
-}
-
-std::string Parameter::to_string(std::string indent) const
-{
-	return name + ": " + value_to_string() + unit;
-}
-
-BoolParameter::BoolParameter(const std::string& nm, const std::string& unt,
-                             bool* v_ptr, bool v_dflt)
-	: Parameter(nm, unt), value_ptr(v_ptr)
-{
-	*value_ptr = v_dflt;
-}
-
-std::string BoolParameter::value_to_string() const
-{
-	return std::to_string(*value_ptr);
-}
-
-float BoolParameter::float_value() const
-{
-	return (float)*value_ptr;
-}
-
-void BoolParameter::set_value(float f)
-{
-	*value_ptr = (bool)std::round(f);
-}
-
-float BoolParameter::norm_float_value() const
-{
-	return float_value();
-}
-
-void BoolParameter::set_norm_value(float nf)
-{
-	set_value(nf);
-}
-
-float BoolParameter::float_low() const
-{
-	return 0.0f;
-}
-
-float BoolParameter::float_up() const
-{
-	return 1.0f;
-}
-
-std::string IntParameter::value_to_string() const
-{
-	return std::to_string(*value_ptr);
-}
-
-IntParameter::IntParameter(const std::string& nm, const std::string& unt,
-                           int* v_ptr, int v_dflt, int l, int u)
-	: Parameter(nm, unt), value_ptr(v_ptr), low(l), up(u)
-{
-	*value_ptr = v_dflt;
-}
-
-float IntParameter::float_value() const
-{
-	return (float)*value_ptr;
-}
-
-void IntParameter::set_value(float f)
-{
-	*value_ptr = std::lround(f);
-}
-
-float IntParameter::norm_float_value() const
-{
-	return affine(low, up, 0.0f, 1.0f, (float)*value_ptr);
-}
-
-void IntParameter::set_norm_value(float nf)
-{
-	*value_ptr = std::lround(affine(0.0f, 1.0f, low, up, nf));
-}
-
-float IntParameter::float_low() const
-{
-	return (float)low;
-}
-
-float IntParameter::float_up() const
-{
-	return (float)up;
-}
-
-FloatParameter::FloatParameter(const std::string& nm, const std::string& unt,
-                               float* v_ptr, float v_dflt, float l, float u)
-	: Parameter(nm, unt), value_ptr(v_ptr), low(l), up(u)
-{
-	*value_ptr = v_dflt;
-}
-
-float FloatParameter::float_value() const
-{
-	return *value_ptr;
-}
-
-void FloatParameter::set_value(float f)
-{
-	*value_ptr = f;
-}
-
-float FloatParameter::float_low() const
-{
-	return low;
-}
-
-float FloatParameter::float_up() const
-{
-	return up;
-}
-
-std::string FloatParameter::value_to_string() const
-{
-	return std::to_string(*value_ptr);
-}
-
-LinearFloatParameter::LinearFloatParameter(const std::string& nm, const std::string& unt,
-                                           float* v_ptr, float v_dflt, float l, float u)
-	: FloatParameter(nm, unt, v_ptr, v_dflt, l, u)
-{
-}
-
-float LinearFloatParameter::norm_float_value() const
-{
-	return affine(low, up, 0.0f, 1.0f, *value_ptr);
-}
-
-void LinearFloatParameter::set_norm_value(float nf)
-{
-	*value_ptr = affine(0.0f, 1.0f, low, up, nf);
-}
-
-CubeFloatParameter::CubeFloatParameter(const std::string& nm, const std::string& unt,
-                                       float* v_ptr, float v_dflt, float l, float u)
-	: FloatParameter(nm, unt, v_ptr, v_dflt, l, u)
-	, cbrt_low(std::cbrt(l))
-	, cbrt_up(std::cbrt(u))
-{
-}
-
-float CubeFloatParameter::norm_float_value() const
-{
-	return affine(cbrt_low, cbrt_up, 0.0f, 1.0f, std::cbrt(*value_ptr));
-}
-
-void CubeFloatParameter::set_norm_value(float nf)
-{
-	*value_ptr = std::pow(affine(0.0f, 1.0f, cbrt_low, cbrt_up, nf), 3.0);
-}
-
-TanFloatParameter::TanFloatParameter(const std::string& nm, const std::string& unt,
-                                     float* v_ptr, float v_dflt, float l, float u,
-                                     bool prcnt)
-	: FloatParameter(nm, unt, v_ptr, v_dflt, l, u)
-	, atan_low(atanf(l))
-	, atan_up(atanf(u))
-	, percent(prcnt)
-{
-}
+namespace {
 
-float TanFloatParameter::norm_float_value() const
+// Copy name into dst, followed by index, separated by a space, unless
+// index is negative
+constexpr void copy_name(char* dst, const char* name, int index)
 {
-	if (*value_ptr == low)
-		return 0.0f;
-	if (*value_ptr == up)
-		return 1.0f;
-	return affine(atan_low, atan_up, 0.0f, 1.0f, atanf(*value_ptr));
-}
-
-void TanFloatParameter::set_norm_value(float nf)
-{
-	if (nf == 0.0f)
-		*value_ptr = low;
-	else if (nf == 1.0f)
-		*value_ptr = up;
-	else
-		*value_ptr = tanf(affine(0.0f, 1.0f, atan_low, atan_up, nf));
-}
-
-BaseEnumParameter::BaseEnumParameter(const std::string& name, const std::string& unit, size_t cnt)
-	: Parameter(name, unit), count(cnt)
-{
-}
-
-float BaseEnumParameter::float_low() const
-{
-	return 0.0f;
-}
-
-float BaseEnumParameter::float_up() const
-{
-	return (float)count - 1.0f;
-}
-
-Parameters::Parameters(Zynayumi& zyn, Patch& pat)
-	: zynayumi(zyn)
-	, patch(pat)
-	, parameters(PARAMETERS_COUNT)
-{
-	// Emulation mode (YM2149 vs AY-3-8910)
-	parameters[EMUL_MODE] = new EnumParameter<EmulMode>(EMUL_MODE_NAME,
-	                                                    EMUL_MODE_UNIT,
-	                                                    &patch.emulmode,
-	                                                    EMUL_MODE_DFLT);
-
-	// Cantus mode
-	parameters[CANTUS_MODE] = new EnumParameter<CantusMode>(CANTUS_MODE_NAME,
-	                                                        CANTUS_MODE_UNIT,
-	                                                        &patch.cantusmode,
-	                                                        CANTUS_MODE_DFLT);
-
-	// Play mode
-	parameters[PLAY_MODE] = new EnumParameter<PlayMode>(PLAY_MODE_NAME,
-	                                                    PLAY_MODE_UNIT,
-	                                                    &patch.playmode,
-	                                                    PLAY_MODE_DFLT);
-
-	// Tone
-	parameters[TONE_RESET] = new BoolParameter(TONE_RESET_NAME,
-	                                           TONE_RESET_UNIT,
-	                                           &patch.tone.reset,
-	                                           TONE_RESET_DFLT);
-
-	parameters[TONE_PHASE] = new LinearFloatParameter(TONE_PHASE_NAME,
-	                                                  TONE_PHASE_UNIT,
-	                                                  &patch.tone.phase,
-	                                                  TONE_PHASE_DFLT,
-	                                                  TONE_PHASE_L,
-	                                                  TONE_PHASE_U);
-
-	parameters[TONE_TIME] = new TanFloatParameter(TONE_TIME_NAME,
-	                                              TONE_TIME_UNIT,
-	                                              &patch.tone.time,
-	                                              TONE_TIME_DFLT,
-	                                              TONE_TIME_L,
-	                                              TONE_TIME_U,
-	                                              true);
-
-	parameters[TONE_DETUNE] = new TanFloatParameter(TONE_DETUNE_NAME,
-	                                                TONE_DETUNE_UNIT,
-	                                                &tone_detune,
-	                                                TONE_DETUNE_DFLT,
-	                                                TONE_DETUNE_L,
-	                                                TONE_DETUNE_U);
-
-	parameters[TONE_TRANSPOSE] = new IntParameter(TONE_TRANSPOSE_NAME,
-	                                              TONE_TRANSPOSE_UNIT,
-	                                              &tone_transpose,
-	                                              TONE_TRANSPOSE_DFLT,
-	                                              TONE_TRANSPOSE_L,
-	                                              TONE_TRANSPOSE_U);
-
-	parameters[TONE_SPREAD] = new LinearFloatParameter(TONE_SPREAD_NAME,
-	                                                   TONE_SPREAD_UNIT,
-	                                                   &patch.tone.spread,
-	                                                   TONE_SPREAD_DFLT,
-	                                                   TONE_SPREAD_L,
-	                                                   TONE_SPREAD_U);
-
-	parameters[TONE_LEGACY_TUNING] = new BoolParameter(TONE_LEGACY_TUNING_NAME,
-	                                                   TONE_LEGACY_TUNING_UNIT,
-	                                                   &patch.tone.legacy_tuning,
-	                                                   TONE_LEGACY_TUNING_DFLT);
-
-	// Noise
-	parameters[NOISE_TIME] = new TanFloatParameter(NOISE_TIME_NAME,
-	                                               NOISE_TIME_UNIT,
-	                                               &patch.noise.time,
-	                                               NOISE_TIME_DFLT,
-	                                               NOISE_TIME_L,
-	                                               NOISE_TIME_U,
-	                                               true);
-
-	parameters[NOISE_PERIOD] = new IntParameter(NOISE_PERIOD_NAME,
-	                                            NOISE_PERIOD_UNIT,
-	                                            &patch.noise.period,
-	                                            NOISE_PERIOD_DFLT,
-	                                            NOISE_PERIOD_L,
-	                                            NOISE_PERIOD_U);
-
-	// Noise Period Envelope
-	parameters[NOISE_PERIOD_ENV_ATTACK] = new IntParameter(NOISE_PERIOD_ENV_ATTACK_NAME,
-	                                                       NOISE_PERIOD_ENV_ATTACK_UNIT,
-	                                                       &patch.noise_period_env.attack,
-	                                                       NOISE_PERIOD_ENV_ATTACK_DFLT,
-	                                                       NOISE_PERIOD_ENV_ATTACK_L,
-	                                                       NOISE_PERIOD_ENV_ATTACK_U);
-
-	parameters[NOISE_PERIOD_ENV_TIME] = new TanFloatParameter(NOISE_PERIOD_ENV_TIME_NAME,
-	                                                          NOISE_PERIOD_ENV_TIME_UNIT,
-	                                                          &patch.noise_period_env.time,
-	                                                          NOISE_PERIOD_ENV_TIME_DFLT,
-	                                                          NOISE_PERIOD_ENV_TIME_L,
-	                                                          NOISE_PERIOD_ENV_TIME_U);
-
-	// Amplitude envelope
-	parameters[ENV_ATTACK_TIME] = new TanFloatParameter(ENV_ATTACK_TIME_NAME,
-	                                                    ENV_ATTACK_TIME_UNIT,
-	                                                    &patch.env.attack_time,
-	                                                    ENV_ATTACK_TIME_DFLT,
-	                                                    ENV_ATTACK_TIME_L,
-	                                                    ENV_ATTACK_TIME_U);
-
-	parameters[ENV_HOLD1_LEVEL] = new IntParameter(ENV_HOLD1_LEVEL_NAME,
-	                                               ENV_HOLD1_LEVEL_UNIT,
-	                                               &patch.env.hold1_level,
-	                                               ENV_HOLD1_LEVEL_DFLT,
-	                                               ENV_HOLD1_LEVEL_L,
-	                                               ENV_HOLD1_LEVEL_U);
-
-	parameters[ENV_INTER1_TIME] = new TanFloatParameter(ENV_INTER1_TIME_NAME,
-	                                                    ENV_INTER1_TIME_UNIT,
-	                                                    &patch.env.inter1_time,
-	                                                    ENV_INTER1_TIME_DFLT,
-	                                                    ENV_INTER1_TIME_L,
-	                                                    ENV_INTER1_TIME_U);
-
-	parameters[ENV_HOLD2_LEVEL] = new IntParameter(ENV_HOLD2_LEVEL_NAME,
-	                                               ENV_HOLD2_LEVEL_UNIT,
-	                                               &patch.env.hold2_level,
-	                                               ENV_HOLD2_LEVEL_DFLT,
-	                                               ENV_HOLD2_LEVEL_L,
-	                                               ENV_HOLD2_LEVEL_U);
-
-	parameters[ENV_INTER2_TIME] = new TanFloatParameter(ENV_INTER2_TIME_NAME,
-	                                                    ENV_INTER2_TIME_UNIT,
-	                                                    &patch.env.inter2_time,
-	                                                    ENV_INTER2_TIME_DFLT,
-	                                                    ENV_INTER2_TIME_L,
-	                                                    ENV_INTER2_TIME_U);
-
-	parameters[ENV_HOLD3_LEVEL] = new IntParameter(ENV_HOLD3_LEVEL_NAME,
-	                                               ENV_HOLD3_LEVEL_UNIT,
-	                                               &patch.env.hold3_level,
-	                                               ENV_HOLD3_LEVEL_DFLT,
-	                                               ENV_HOLD3_LEVEL_L,
-	                                               ENV_HOLD3_LEVEL_U);
-
-	parameters[ENV_DECAY_TIME] = new TanFloatParameter(ENV_DECAY_TIME_NAME,
-	                                                   ENV_DECAY_TIME_UNIT,
-	                                                   &patch.env.decay_time,
-	                                                   ENV_DECAY_TIME_DFLT,
-	                                                   ENV_DECAY_TIME_L,
-	                                                   ENV_DECAY_TIME_U);
-
-	parameters[ENV_SUSTAIN_LEVEL] = new IntParameter(ENV_SUSTAIN_LEVEL_NAME,
-	                                                 ENV_SUSTAIN_LEVEL_UNIT,
-	                                                 &patch.env.sustain_level,
-	                                                 ENV_SUSTAIN_LEVEL_DFLT,
-	                                                 ENV_SUSTAIN_LEVEL_L,
-	                                                 ENV_SUSTAIN_LEVEL_U);
-
-	parameters[ENV_RELEASE] = new TanFloatParameter(ENV_RELEASE_NAME,
-	                                                ENV_RELEASE_UNIT,
-	                                                &patch.env.release,
-	                                                ENV_RELEASE_DFLT,
-	                                                ENV_RELEASE_L,
-	                                                ENV_RELEASE_U);
-
-	// Pitch envelope
-	parameters[PITCH_ENV_ATTACK_PITCH] = new IntParameter(PITCH_ENV_ATTACK_PITCH_NAME,
-	                                                      PITCH_ENV_ATTACK_PITCH_UNIT,
-	                                                      &patch.pitchenv.attack_pitch,
-	                                                      PITCH_ENV_ATTACK_PITCH_DFLT,
-	                                                      PITCH_ENV_ATTACK_PITCH_L,
-	                                                      PITCH_ENV_ATTACK_PITCH_U);
-
-	parameters[PITCH_ENV_TIME] = new TanFloatParameter(PITCH_ENV_TIME_NAME,
-	                                                   PITCH_ENV_TIME_UNIT,
-	                                                   &patch.pitchenv.time,
-	                                                   PITCH_ENV_TIME_DFLT,
-	                                                   PITCH_ENV_TIME_L,
-	                                                   PITCH_ENV_TIME_U);
-
-	parameters[PITCH_ENV_SMOOTHNESS] = new LinearFloatParameter(PITCH_ENV_SMOOTHNESS_NAME,
-	                                                            PITCH_ENV_SMOOTHNESS_UNIT,
-	                                                            &patch.pitchenv.smoothness,
-	                                                            PITCH_ENV_SMOOTHNESS_DFLT,
-	                                                            PITCH_ENV_SMOOTHNESS_L,
-	                                                            PITCH_ENV_SMOOTHNESS_U);
-
-	// Ring modulation
-	for (unsigned i = 0; i < RINGMOD_WAVEFORM_SIZE; i++) {
-		std::string rwl_name = RINGMOD_WAVEFORM_LEVEL_NAME;
-		rwl_name += " ";
-		rwl_name += std::to_string(i);
-		parameters[RINGMOD_WAVEFORM_LEVEL1 + i] = new IntParameter(rwl_name,
-		                                                           RINGMOD_WAVEFORM_LEVEL_UNIT,
-		                                                           &patch.ringmod.waveform[i],
-		                                                           RINGMOD_WAVEFORM_LEVEL_DFLT,
-		                                                           RINGMOD_WAVEFORM_LEVEL_L,
-		                                                           RINGMOD_WAVEFORM_LEVEL_U);
+	size_t n = 0;
+	for (; name[n] != '\0'; n++)
+		dst[n] = name[n];
+	if (0 <= index) {
+		dst[n++] = ' ';
+		if (10 <= index)
+			dst[n++] = '0' + index / 10;
+		dst[n++] = '0' + index % 10;
 	}
-
-	parameters[RINGMOD_RESET] = new BoolParameter(RINGMOD_RESET_NAME,
-	                                              RINGMOD_RESET_UNIT,
-	                                              &patch.ringmod.reset,
-	                                              RINGMOD_RESET_DFLT);
-
-	parameters[RINGMOD_SYNC] = new BoolParameter(RINGMOD_SYNC_NAME,
-	                                             RINGMOD_SYNC_UNIT,
-	                                             &patch.ringmod.sync,
-	                                             RINGMOD_SYNC_DFLT);
-
-	parameters[RINGMOD_PHASE] = new LinearFloatParameter(RINGMOD_PHASE_NAME,
-	                                                     RINGMOD_PHASE_UNIT,
-	                                                     &patch.ringmod.phase,
-	                                                     RINGMOD_PHASE_DFLT,
-	                                                     RINGMOD_PHASE_L,
-	                                                     RINGMOD_PHASE_U);
-
-	parameters[RINGMOD_LOOP] = new EnumParameter<RingMod::Loop>(RINGMOD_LOOP_NAME,
-	                                                            RINGMOD_LOOP_UNIT,
-	                                                            &patch.ringmod.loop,
-	                                                            RINGMOD_LOOP_DFLT);
-
-	parameters[RINGMOD_DETUNE] = new TanFloatParameter(RINGMOD_DETUNE_NAME,
-	                                                   RINGMOD_DETUNE_UNIT,
-	                                                   &ringmod_detune,
-	                                                   RINGMOD_DETUNE_DFLT,
-	                                                   RINGMOD_DETUNE_L,
-	                                                   RINGMOD_DETUNE_U);
-
-	parameters[RINGMOD_TRANSPOSE] = new IntParameter(RINGMOD_TRANSPOSE_NAME,
-	                                                 RINGMOD_TRANSPOSE_UNIT,
-	                                                 &ringmod_transpose,
-	                                                 RINGMOD_TRANSPOSE_DFLT,
-	                                                 RINGMOD_TRANSPOSE_L,
-	                                                 RINGMOD_TRANSPOSE_U);
-
-	parameters[RINGMOD_FIXED_PITCH] = new LinearFloatParameter(RINGMOD_FIXED_PITCH_NAME,
-	                                                           RINGMOD_FIXED_PITCH_UNIT,
-	                                                           &patch.ringmod.fixed_pitch,
-	                                                           RINGMOD_FIXED_PITCH_DFLT,
-	                                                           RINGMOD_FIXED_PITCH_L,
-	                                                           RINGMOD_FIXED_PITCH_U);
-
-	parameters[RINGMOD_FIXED_VS_RELATIVE] = new TanFloatParameter(RINGMOD_FIXED_VS_RELATIVE_NAME,
-	                                                              RINGMOD_FIXED_VS_RELATIVE_UNIT,
-	                                                              &patch.ringmod.fixed_vs_relative,
-	                                                              RINGMOD_FIXED_VS_RELATIVE_DFLT,
-	                                                              RINGMOD_FIXED_VS_RELATIVE_L,
-	                                                              RINGMOD_FIXED_VS_RELATIVE_U);
-
-	parameters[RINGMOD_DEPTH] = new IntParameter(RINGMOD_DEPTH_NAME,
-	                                             RINGMOD_DEPTH_UNIT,
-	                                             &patch.ringmod.depth,
-	                                             RINGMOD_DEPTH_DFLT,
-	                                             RINGMOD_DEPTH_L,
-	                                             RINGMOD_DEPTH_U);
-
-	// Buzzer
-	parameters[BUZZER_ENABLED] = new BoolParameter(BUZZER_ENABLED_NAME,
-	                                               BUZZER_ENABLED_UNIT,
-	                                               &patch.buzzer.enabled,
-	                                               BUZZER_ENABLED_DFLT);
-
-	parameters[BUZZER_SHAPE] = new EnumParameter<Buzzer::Shape>(BUZZER_SHAPE_NAME,
-	                                                            BUZZER_SHAPE_UNIT,
-	                                                            &patch.buzzer.shape,
-	                                                            BUZZER_SHAPE_DFLT);
-
-	// Sequencer
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string stp_name = SEQ_TONE_PITCH_NAME;
-		stp_name += " ";
-		stp_name += std::to_string(i);
-		parameters[SEQ_TONE_PITCH_0 + i] = new IntParameter(stp_name,
-		                                                    SEQ_TONE_PITCH_UNIT,
-		                                                    &patch.seq.states[i].tone_pitch,
-		                                                    SEQ_TONE_PITCH_DFLT,
-		                                                    SEQ_TONE_PITCH_L,
-		                                                    SEQ_TONE_PITCH_U);
+	dst[n] = '\0';
+}
+
+// Copy name into dst in lower case and without space
+constexpr void copy_symbol(char* dst, const char* name)
+{
+	size_t n = 0;
+	for (; *name != '\0'; name++)
+		if (*name != ' ')
+			dst[n++] = 'A' <= *name and *name <= 'Z' ? *name - 'A' + 'a' : *name;
+	dst[n] = '\0';
+}
+
+template<typename E>
+std::string enum_value_name(size_t ei)
+{
+	return zynayumi::to_string((E)ei); // defined in patch.{hpp,cpp}
+}
+
+// Return the descriptor of a parameter, given its schema. The type of
+// dflt determines the enumerated values of an Enum parameter.
+template<typename T>
+constexpr ParameterDescriptor descriptor(const char* name, int index,
+                                         const char* unit,
+                                         ParameterKind kind,
+                                         ParameterMapping mapping,
+                                         ParameterOwner owner, size_t offset,
+                                         T dflt, float low, float up,
+                                         bool percent)
+{
+	ParameterDescriptor d{};
+	copy_name(d.name, name, index);
+	copy_symbol(d.symbol, d.name);
+	d.unit = unit;
+	d.kind = kind;
+	d.mapping = mapping;
+	d.percent = percent;
+	d.owner = owner;
+	d.offset = offset;
+	d.dflt = (float)dflt;
+	d.low = low;
+	d.up = up;
+	d.count = 0;
+	d.enum_value_name = nullptr;
+	if constexpr (std::is_enum<T>::value) {
+		// Enum values are accessed as int
+		static_assert(sizeof(T) == sizeof(int));
+		d.low = 0.0f;
+		d.up = (float)T::Count - 1.0f;
+		d.count = (size_t)T::Count;
+		d.enum_value_name = enum_value_name<T>;
 	}
-
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string snp_name = SEQ_NOISE_PERIOD_NAME;
-		snp_name += " ";
-		snp_name += std::to_string(i);
-		parameters[SEQ_NOISE_PERIOD_0 + i] = new IntParameter(snp_name,
-		                                                      SEQ_NOISE_PERIOD_UNIT,
-		                                                      &patch.seq.states[i].noise_period,
-		                                                      SEQ_NOISE_PERIOD_DFLT,
-		                                                      SEQ_NOISE_PERIOD_L,
-		                                                      SEQ_NOISE_PERIOD_U);
+	return d;
+}
+
+// Owner and offset of a value of the patch, of an element of an array
+// of the patch, of a member of a sequencer state, of a value of
+// ExtraParameters and of a value of EngineSettings
+#define PATCH(member) ParameterOwner::Patch, offsetof(Patch, member)
+#define PATCH_ELEMENT(array, i) ParameterOwner::Patch,                 \
+		offsetof(Patch, array) + (i) * sizeof(std::declval<Patch>().array[0])
+#define SEQ_STATE(i, member) ParameterOwner::Patch,                    \
+		offsetof(Patch, seq.states) + (i) * sizeof(Seq::State)             \
+		+ offsetof(Seq::State, member)
+#define EXTRA(member) ParameterOwner::Parameters, offsetof(ExtraParameters, member)
+#define ENGINE(member) ParameterOwner::Engine, offsetof(EngineSettings, member)
+
+// The schema lists as many waveform levels and sequencer states
+static_assert(RINGMOD_WAVEFORM_SIZE == 16 and Seq::size == 16);
+
+typedef std::array<ParameterDescriptor, PARAMETERS_COUNT> ParameterDescriptors;
+
+constexpr ParameterDescriptors make_descriptors()
+{
+	ParameterDescriptors d{};
+
+#define PARAMETER(id, kind, name, unit, mapping, binding,                \
+                  dflt, low, up, percent)                                 \
+	d[id] = descriptor(name, -1, unit, ParameterKind::kind,              \
+	                   ParameterMapping::mapping, binding,               \
+	                   dflt, low, up, percent);
+#define PARAMETER_ARRAY(stem, first, count, kind, name, unit, mapping,   \
+                        binding, dflt, low, up)                           \
+	for (int i = 0; i < count; i++)                                      \
+		d[stem##first + i] = descriptor(name, i, unit, ParameterKind::kind, \
+		                                ParameterMapping::mapping, binding, \
+		                                dflt, low, up, false);
+#include "parameters.def"
+
+	return d;
+}
+
+#undef PATCH
+#undef PATCH_ELEMENT
+#undef SEQ_STATE
+#undef EXTRA
+#undef ENGINE
+
+// Descriptors of all parameters, indexed by ParameterIndex
+constexpr ParameterDescriptors DESCRIPTORS = make_descriptors();
+
+// Return the value at value_ptr of a parameter described by d, in float
+float to_float(const ParameterDescriptor& d, const void* value_ptr)
+{
+	switch (d.kind) {
+	case ParameterKind::Bool:
+		return (float)*(const bool*)value_ptr;
+	case ParameterKind::Int:
+		return (float)*(const int*)value_ptr;
+	case ParameterKind::Enum: {
+		int e;
+		std::memcpy(&e, value_ptr, sizeof(e));
+		return (float)e;
 	}
-
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string srp_name = SEQ_RINGMOD_PITCH_NAME;
-		srp_name += " ";
-		srp_name += std::to_string(i);
-		parameters[SEQ_RINGMOD_PITCH_0 + i] = new IntParameter(srp_name,
-		                                                       SEQ_RINGMOD_PITCH_UNIT,
-		                                                       &patch.seq.states[i].ringmod_pitch,
-		                                                       SEQ_RINGMOD_PITCH_DFLT,
-		                                                       SEQ_RINGMOD_PITCH_L,
-		                                                       SEQ_RINGMOD_PITCH_U);
+	default:
+		return *(const float*)value_ptr;
 	}
+}
 
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string srd_name = SEQ_RINGMOD_DEPTH_NAME;
-		srd_name += " ";
-		srd_name += std::to_string(i);
-		parameters[SEQ_RINGMOD_DEPTH_0 + i] = new IntParameter(srd_name,
-		                                                       SEQ_RINGMOD_DEPTH_UNIT,
-		                                                       &patch.seq.states[i].ringmod_depth,
-		                                                       SEQ_RINGMOD_DEPTH_DFLT,
-		                                                       SEQ_RINGMOD_DEPTH_L,
-		                                                       SEQ_RINGMOD_DEPTH_U);
+// Set the value at value_ptr of a parameter described by d, given a
+// float
+void from_float(const ParameterDescriptor& d, void* value_ptr, float f)
+{
+	switch (d.kind) {
+	case ParameterKind::Bool:
+		*(bool*)value_ptr = (bool)std::round(f);
+		break;
+	case ParameterKind::Int:
+		*(int*)value_ptr = std::lround(f);
+		break;
+	case ParameterKind::Enum: {
+		int e = std::lround(f);
+		std::memcpy(value_ptr, &e, sizeof(e));
+		break;
 	}
-
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string sl_name = SEQ_LEVEL_NAME;
-		sl_name += " ";
-		sl_name += std::to_string(i);
-		parameters[SEQ_LEVEL_0 + i] = new IntParameter(sl_name,
-		                                               SEQ_LEVEL_UNIT,
-		                                               &patch.seq.states[i].level,
-		                                               SEQ_LEVEL_DFLT,
-		                                               SEQ_LEVEL_L,
-		                                               SEQ_LEVEL_U);
+	default:
+		*(float*)value_ptr = f;
+		break;
 	}
+}
 
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string sto_name = SEQ_TONE_ON_NAME;
-		sto_name += " ";
-		sto_name += std::to_string(i);
-		parameters[SEQ_TONE_ON_0 + i] = new BoolParameter(sto_name,
-		                                                  SEQ_TONE_ON_UNIT,
-		                                                  &patch.seq.states[i].tone_on,
-		                                                  SEQ_TONE_ON_DFLT);
+// Return the value at value_ptr of a parameter described by d,
+// normalized within [0, 1]
+float to_norm(const ParameterDescriptor& d, const void* value_ptr)
+{
+	float v = to_float(d, value_ptr);
+	switch (d.kind) {
+	case ParameterKind::Bool:
+		return v;
+	case ParameterKind::Enum:
+		return v / (float)(d.count - 1);
+	default:
+		break;
 	}
-
-	for (unsigned i = 0; i < Seq::size; i++) {
-		std::string sno_name = SEQ_NOISE_ON_NAME;
-		sno_name += " ";
-		sno_name += std::to_string(i);
-		parameters[SEQ_NOISE_ON_0 + i] = new BoolParameter(sno_name,
-		                                                   SEQ_NOISE_ON_UNIT,
-		                                                   &patch.seq.states[i].noise_on,
-		                                                   SEQ_NOISE_ON_DFLT);
+	switch (d.mapping) {
+	case ParameterMapping::Cube:
+		return affine(std::cbrt(d.low), std::cbrt(d.up), 0.0f, 1.0f, std::cbrt(v));
+	case ParameterMapping::Tan:
+		if (v == d.low)
+			return 0.0f;
+		if (v == d.up)
+			return 1.0f;
+		return affine(atanf(d.low), atanf(d.up), 0.0f, 1.0f, atanf(v));
+	default:
+		return affine(d.low, d.up, 0.0f, 1.0f, v);
 	}
+}
 
-	parameters[SEQ_MODE] = new EnumParameter<Seq::Mode>(SEQ_MODE_NAME,
-	                                                    SEQ_MODE_UNIT,
-	                                                    &patch.seq.mode,
-	                                                    SEQ_MODE_DFLT);
-
-	parameters[SEQ_TEMPO] = new LinearFloatParameter(SEQ_TEMPO_NAME,
-	                                                 SEQ_TEMPO_UNIT,
-	                                                 &patch.seq.tempo,
-	                                                 SEQ_TEMPO_DFLT,
-	                                                 SEQ_TEMPO_L,
-	                                                 SEQ_TEMPO_U);
-
-	parameters[SEQ_HOST_SYNC] = new BoolParameter(SEQ_HOST_SYNC_NAME,
-	                                              SEQ_HOST_SYNC_UNIT,
-	                                              &patch.seq.host_sync,
-	                                              SEQ_HOST_SYNC_DFLT);
-
-	parameters[SEQ_BEAT_DIVISOR] = new IntParameter(SEQ_BEAT_DIVISOR_NAME,
-	                                                SEQ_BEAT_DIVISOR_UNIT,
-	                                                &seq_beat_divisor,
-	                                                SEQ_BEAT_DIVISOR_DFLT,
-	                                                SEQ_BEAT_DIVISOR_L,
-	                                                SEQ_BEAT_DIVISOR_U);
-
-	parameters[SEQ_BEAT_MULTIPLIER] = new IntParameter(SEQ_BEAT_MULTIPLIER_NAME,
-	                                                   SEQ_BEAT_MULTIPLIER_UNIT,
-	                                                   &seq_beat_multiplier,
-	                                                   SEQ_BEAT_MULTIPLIER_DFLT,
-	                                                   SEQ_BEAT_MULTIPLIER_L,
-	                                                   SEQ_BEAT_MULTIPLIER_U);
-
-	parameters[SEQ_LOOP] = new IntParameter(SEQ_LOOP_NAME,
-	                                        SEQ_LOOP_UNIT,
-	                                        &patch.seq.loop,
-	                                        SEQ_LOOP_DFLT,
-	                                        SEQ_LOOP_L,
-	                                        SEQ_LOOP_U);
-
-	parameters[SEQ_END] = new IntParameter(SEQ_END_NAME,
-	                                       SEQ_END_UNIT,
-	                                       &patch.seq.end,
-	                                       SEQ_END_DFLT,
-	                                       SEQ_END_L,
-	                                       SEQ_END_U);
-
-	// Pitch LFO
-	parameters[LFO_SHAPE] = new EnumParameter<LFO::Shape>(LFO_SHAPE_NAME,
-	                                                      LFO_SHAPE_UNIT,
-	                                                      &patch.lfo.shape,
-	                                                      LFO_SHAPE_DFLT);
-
-	parameters[LFO_FREQ] = new LinearFloatParameter(LFO_FREQ_NAME,
-	                                                LFO_FREQ_UNIT,
-	                                                &patch.lfo.freq,
-	                                                LFO_FREQ_DFLT,
-	                                                LFO_FREQ_L,
-	                                                LFO_FREQ_U);
-
-	parameters[LFO_DELAY] = new TanFloatParameter(LFO_DELAY_NAME,
-	                                              LFO_DELAY_UNIT,
-	                                              &patch.lfo.delay,
-	                                              LFO_DELAY_DFLT,
-	                                              LFO_DELAY_L,
-	                                              LFO_DELAY_U);
-
-	parameters[LFO_DEPTH] = new TanFloatParameter(LFO_DEPTH_NAME,
-	                                              LFO_DEPTH_UNIT,
-	                                              &patch.lfo.depth,
-	                                              LFO_DEPTH_DFLT,
-	                                              LFO_DEPTH_L,
-	                                              LFO_DEPTH_U);
-
-	// Portamento
-	parameters[PORTAMENTO_TIME] = new TanFloatParameter(PORTAMENTO_TIME_NAME,
-	                                                    PORTAMENTO_TIME_UNIT,
-	                                                    &patch.portamento.time,
-	                                                    PORTAMENTO_TIME_DFLT,
-	                                                    PORTAMENTO_TIME_L,
-	                                                    PORTAMENTO_TIME_U);
-
-	parameters[PORTAMENTO_SMOOTHNESS] = new LinearFloatParameter(PORTAMENTO_SMOOTHNESS_NAME,
-	                                                             PORTAMENTO_SMOOTHNESS_UNIT,
-	                                                             &patch.portamento.smoothness,
-	                                                             PORTAMENTO_SMOOTHNESS_DFLT,
-	                                                             PORTAMENTO_SMOOTHNESS_L,
-	                                                             PORTAMENTO_SMOOTHNESS_U);
-
-	// YM Channel Enabled
-	for (unsigned i = 0; i < 3; i++) {
-		std::string e_name = YM_CHANNEL_ENABLED_NAME;
-		e_name += " ";
-		e_name += std::to_string(i);
-		parameters[YM_CHANNEL_ENABLED_0 + i] = new BoolParameter(e_name,
-		                                                         YM_CHANNEL_ENABLED_UNIT,
-		                                                         &patch.mixer.enabled[i],
-		                                                         YM_CHANNEL_ENABLED_DFLT);
+// Set the value at value_ptr of a parameter described by d, given a
+// normalized float within [0, 1]
+void from_norm(const ParameterDescriptor& d, void* value_ptr, float nf)
+{
+	switch (d.kind) {
+	case ParameterKind::Bool:
+		from_float(d, value_ptr, nf);
+		return;
+	case ParameterKind::Int:
+		from_float(d, value_ptr, affine(0.0f, 1.0f, d.low, d.up, nf));
+		return;
+	case ParameterKind::Enum:
+		from_float(d, value_ptr, nf * (float)(d.count - 1));
+		return;
+	default:
+		break;
 	}
-
-	// Pan
-	parameters[PAN_0] = new LinearFloatParameter(PAN_0_NAME,
-	                                             PAN_UNIT,
-	                                             &patch.mixer.pan[0],
-	                                             PAN_0_DFLT,
-	                                             PAN_L,
-	                                             PAN_U);
-
-	parameters[PAN_1] = new LinearFloatParameter(PAN_1_NAME,
-	                                             PAN_UNIT,
-	                                             &patch.mixer.pan[1],
-	                                             PAN_1_DFLT,
-	                                             PAN_L,
-	                                             PAN_U);
-
-	parameters[PAN_2] = new LinearFloatParameter(PAN_2_NAME,
-	                                             PAN_UNIT,
-	                                             &patch.mixer.pan[2],
-	                                             PAN_2_DFLT,
-	                                             PAN_L,
-	                                             PAN_U);
-
-	// Gain
-	parameters[GAIN] = new LinearFloatParameter(GAIN_NAME,
-	                                            GAIN_UNIT,
-	                                            &patch.mixer.gain,
-	                                            GAIN_DFLT,
-	                                            GAIN_L,
-	                                            GAIN_U);
-
-	// Control
-	parameters[PITCH_WHEEL] = new IntParameter(PITCH_WHEEL_NAME,
-	                                           PITCH_WHEEL_UNIT,
-	                                           &patch.control.pitchwheel,
-	                                           PITCH_WHEEL_DFLT,
-	                                           PITCH_WHEEL_L,
-	                                           PITCH_WHEEL_U);
-
-	parameters[VELOCITY_SENSITIVITY] = new LinearFloatParameter(VELOCITY_SENSITIVITY_NAME,
-	                                                            VELOCITY_SENSITIVITY_UNIT,
-	                                                            &patch.control.velocity_sensitivity,
-	                                                            VELOCITY_SENSITIVITY_DFLT,
-	                                                            VELOCITY_SENSITIVITY_L,
-	                                                            VELOCITY_SENSITIVITY_U);
-
-	parameters[RINGMOD_VELOCITY_SENSITIVITY] = new LinearFloatParameter(RINGMOD_VELOCITY_SENSITIVITY_NAME,
-	                                                                    RINGMOD_VELOCITY_SENSITIVITY_UNIT,
-	                                                                    &patch.control.ringmod_velocity_sensitivity,
-	                                                                    RINGMOD_VELOCITY_SENSITIVITY_DFLT,
-	                                                                    RINGMOD_VELOCITY_SENSITIVITY_L,
-	                                                                    RINGMOD_VELOCITY_SENSITIVITY_U);
-
-	parameters[NOISE_PERIOD_PITCH_SENSITIVITY] = new LinearFloatParameter(NOISE_PERIOD_PITCH_SENSITIVITY_NAME,
-	                                                                      NOISE_PERIOD_PITCH_SENSITIVITY_UNIT,
-	                                                                      &patch.control.noise_period_pitch_sensitivity,
-	                                                                      NOISE_PERIOD_PITCH_SENSITIVITY_DFLT,
-	                                                                      NOISE_PERIOD_PITCH_SENSITIVITY_L,
-	                                                                      NOISE_PERIOD_PITCH_SENSITIVITY_U);
-
-	parameters[MODULATION_SENSITIVITY] = new TanFloatParameter(MODULATION_SENSITIVITY_NAME,
-	                                                           MODULATION_SENSITIVITY_UNIT,
-	                                                           &patch.control.modulation_sensitivity,
-	                                                           MODULATION_SENSITIVITY_DFLT,
-	                                                           MODULATION_SENSITIVITY_L,
-	                                                           MODULATION_SENSITIVITY_U);
-
-	// MIDI channel per YM channel
-	for (unsigned i = 0; i < 3; i++) {
-		std::string mc_name = MIDI_CHANNEL_NAME;
-		mc_name += " ";
-		mc_name += std::to_string(i);
-		parameters[MIDI_CHANNEL_0 + i] = new EnumParameter<Control::MidiChannel>(mc_name,
-		                                                                         MIDI_CHANNEL_UNIT,
-		                                                                         &patch.control.midi_ch[i],
-		                                                                         MIDI_CHANNEL_DFLT);
+	float f;
+	switch (d.mapping) {
+	case ParameterMapping::Cube:
+		f = std::pow(affine(0.0f, 1.0f, std::cbrt(d.low), std::cbrt(d.up), nf), 3.0);
+		break;
+	case ParameterMapping::Tan:
+		if (nf == 0.0f)
+			f = d.low;
+		else if (nf == 1.0f)
+			f = d.up;
+		else
+			f = tanf(affine(0.0f, 1.0f, atanf(d.low), atanf(d.up), nf));
+		break;
+	default:
+		f = affine(0.0f, 1.0f, d.low, d.up, nf);
+		break;
 	}
-
-	// Oversampling
-	parameters[OVERSAMPLING] = new IntParameter(OVERSAMPLING_NAME,
-	                                            OVERSAMPLING_UNIT,
-	                                            &zynayumi.engine.oversampling,
-	                                            OVERSAMPLING_DFLT,
-	                                            OVERSAMPLING_L,
-	                                            OVERSAMPLING_U);
+	*(float*)value_ptr = f;
 }
 
-Parameters::~Parameters()
+} // ~namespace
+
+Parameters::Parameters(Zynayumi& zyn, Patch& pat)
+	: zynayumi(zyn)
+	, patch(pat)
 {
-	for (auto& param : parameters)
-		delete param;
+	// Set all values to their defaults
+	for (int pi = 0; pi < PARAMETERS_COUNT; pi++) {
+		const ParameterDescriptor& d = DESCRIPTORS[pi];
+		from_float(d, get_value_ptr((ParameterIndex)pi), d.dflt);
+	}
 }
 
 Parameters& Parameters::operator=(const Parameters& other)
@@ -800,44 +293,57 @@ Parameters& Parameters::operator=(const Parameters& other)
 	return *this;
 }
 
+const ParameterDescriptor& Parameters::get_descriptor(ParameterIndex pi)
+{
+	return DESCRIPTORS[pi];
+}
+
 std::string Parameters::get_name(ParameterIndex pi) const
 {
-	if (pi < parameters.size())
-		return parameters[pi]->name;
+	if (pi < PARAMETERS_COUNT)
+		return DESCRIPTORS[pi].name;
 	return "";
 }
 
 std::string Parameters::get_symbol(ParameterIndex pi) const
 {
-	std::string symbol = get_name(pi);
-	boost::algorithm::to_lower(symbol);
-	boost::algorithm::erase_all(symbol, " ");
-	return symbol;
+	if (pi < PARAMETERS_COUNT)
+		return DESCRIPTORS[pi].symbol;
+	return "";
 }
 
 std::string Parameters::get_unit(ParameterIndex pi) const
 {
-	if (pi < parameters.size()) {
+	if (pi < PARAMETERS_COUNT) {
 		if (is_percent(pi))
 			return "%";
-		return parameters[pi]->unit;
+		return DESCRIPTORS[pi].unit;
 	}
 	return "";
 }
 
 std::string Parameters::get_value_str(ParameterIndex pi) const
 {
-	if (pi < parameters.size())
-		return parameters[pi]->value_to_string();
-	return "";
+	if (PARAMETERS_COUNT <= pi)
+		return "";
+	const ParameterDescriptor& d = DESCRIPTORS[pi];
+	float f = to_float(d, get_value_ptr(pi));
+	switch (d.kind) {
+	case ParameterKind::Float:
+		return std::to_string(f);
+	case ParameterKind::Enum:
+		return d.enum_value_name((size_t)f);
+	default:
+		return std::to_string((int)f);
+	}
 }
 
 float Parameters::float_value(ParameterIndex pi) const
 {
-	if (pi < parameters.size()) {
+	if (pi < PARAMETERS_COUNT) {
 		if (is_percent(pi))
-			return 100.0f * parameters[pi]->norm_float_value();
-		return parameters[pi]->float_value();
+			return 100.0f * norm_float_value(pi);
+		return to_float(DESCRIPTORS[pi], get_value_ptr(pi));
 	}
 	return 0.0f;
 }
@@ -849,11 +355,11 @@ float to_freq(float bpm, float beat_divisor, float beat_multiplier)
 
 void Parameters::set_value(ParameterIndex pi, float f)
 {
-	if (pi < parameters.size()) {
+	if (pi < PARAMETERS_COUNT) {
 		if (is_percent(pi)) {
-			return parameters[pi]->set_norm_value(f / 100.0f);
+			return from_norm(DESCRIPTORS[pi], get_value_ptr(pi), f / 100.0f);
 		} else {
-			parameters[pi]->set_value(f);
+			from_float(DESCRIPTORS[pi], get_value_ptr(pi), f);
 		}
 		update(pi);
 	}
@@ -861,57 +367,85 @@ void Parameters::set_value(ParameterIndex pi, float f)
 
 float Parameters::norm_float_value(ParameterIndex pi) const
 {
-	if (pi < parameters.size())
-		return parameters[pi]->norm_float_value();
+	if (pi < PARAMETERS_COUNT)
+		return to_norm(DESCRIPTORS[pi], get_value_ptr(pi));
 	return 0.0f;
 }
 
 void Parameters::set_norm_value(ParameterIndex pi, float nf)
 {
-	parameters[pi]->set_norm_value(nf);
+	from_norm(DESCRIPTORS[pi], get_value_ptr(pi), nf);
 	update(pi);
 }
 
+bool Parameters::post_value(ParameterIndex pi, float f, unsigned long frame)
+{
+	return zynayumi.parameter_queue.push({frame, this, pi, f, false});
+}
+
+bool Parameters::post_norm_value(ParameterIndex pi, float nf,
+                                 unsigned long frame)
+{
+	return zynayumi.parameter_queue.push({frame, this, pi, nf, true});
+}
+
 float Parameters::float_low(ParameterIndex pi) const
 {
 	if (is_percent(pi))
 		 return 0.0f;
-	return parameters[pi]->float_low();
+	return DESCRIPTORS[pi].low;
 }
 
 float Parameters::float_up(ParameterIndex pi) const
 {
 	if (is_percent(pi))
 		 return 100.0f;
-	return parameters[pi]->float_up();
+	return DESCRIPTORS[pi].up;
 }
 
 bool Parameters::is_int(ParameterIndex pi) const
 {
-	return dynamic_cast<IntParameter*>(parameters[pi]) or
-		dynamic_cast<BoolParameter*>(parameters[pi]) or
-		dynamic_cast<BaseEnumParameter*>(parameters[pi]);
+	return DESCRIPTORS[pi].kind != ParameterKind::Float;
 }
 
 bool Parameters::is_enum(ParameterIndex pi) const
 {
-	return dynamic_cast<BaseEnumParameter*>(parameters[pi]);
+	return DESCRIPTORS[pi].kind == ParameterKind::Enum;
 }
 
 bool Parameters::is_percent(ParameterIndex pi) const
 {
-	TanFloatParameter* tp = dynamic_cast<TanFloatParameter*>(parameters[pi]);
-	return tp and tp->percent;
+	return DESCRIPTORS[pi].percent;
 }
 
 size_t Parameters::enum_count(ParameterIndex pi) const
 {
-	return dynamic_cast<BaseEnumParameter*>(parameters[pi])->count;
+	return DESCRIPTORS[pi].count;
 }
 
 std::string Parameters::enum_value_name(ParameterIndex pi, size_t ei) const
 {
-	return dynamic_cast<BaseEnumParameter*>(parameters[pi])->enum_value_to_string(ei);
+	return DESCRIPTORS[pi].enum_value_name(ei);
+}
+
+void* Parameters::get_value_ptr(ParameterIndex pi) const
+{
+	const ParameterDescriptor& d = DESCRIPTORS[pi];
+	char* base = nullptr;
+	switch (d.owner) {
+	case ParameterOwner::Patch:
+		base = (char*)&patch;
+		break;
+	case ParameterOwner::Parameters:
+		base = (char*)static_cast<const ExtraParameters*>(this);
+		break;
+	case ParameterOwner::Engine:
+		base = (char*)static_cast<EngineSettings*>(&zynayumi.engine);
+		break;
+	default:
+		break;
+	}
+	return base + d.offset;
 }
 
 void Parameters::update(ParameterIndex pi)
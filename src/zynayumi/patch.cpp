@@ -45,8 +45,28 @@ Env::Env() : attack_time(0),
              hold3_level(MAX_LEVEL), decay_time(0),
              sustain_level(MAX_LEVEL), release(0) {}
 
+bool Env::operator==(const Env& other) const
+{
+	return attack_time == other.attack_time
+		and hold1_level == other.hold1_level
+		and inter1_time == other.inter1_time
+		and hold2_level == other.hold2_level
+		and inter2_time == other.inter2_time
+		and hold3_level == other.hold3_level
+		and decay_time == other.decay_time
+		and sustain_level == other.sustain_level
+		and release == other.release;
+}
+
 PitchEnv::PitchEnv() : attack_pitch(0), time(0), smoothness(0.5) {}
 
+bool PitchEnv::operator==(const PitchEnv& other) const
+{
+	return attack_pitch == other.attack_pitch
+		and time == other.time
+		and smoothness == other.smoothness;
+}
+
 RingMod::RingMod() : waveform{MAX_LEVEL, MAX_LEVEL, MAX_LEVEL, MAX_LEVEL, MAX_LEVEL, MAX_LEVEL, MAX_LEVEL, MAX_LEVEL},
                      reset(true), sync(false), phase(0.0),
                      loop(RingMod::Loop::PingPong), detune(0.0),
@@ -65,7 +85,7 @@ Seq::State::State() : tone_pitch(0),
                       noise_on(true)
 {}
 
-Seq::Seq() : states(Seq::size), mode(Seq::Mode::Forward),
+Seq::Seq() : mode(Seq::Mode::Forward),
              tempo(120), host_sync(1), freq(18.0),
              loop(0), end(0) {}
 
@@ -26,7 +26,6 @@
 #define __ZYNAYUMI_PATCH_HPP
 
 #include <string>
-#include <vector>
 
 namespace zynayumi {
 
@@ -107,6 +106,8 @@ class Env {
 public:
 	Env();
 
+	bool operator==(const Env& other) const;
+
 	float attack_time;           // Attack time
 	int hold1_level;             // Hold-1 level (0-15)
 	float inter1_time;           // Duration between hold-1 and hold-2
@@ -126,6 +127,8 @@ class PitchEnv {
 public:
 	PitchEnv();
 
+	bool operator==(const PitchEnv& other) const;
+
 	int attack_pitch;            // Relative pitch of the attack
 	float time;                  // Duration to go from attack pitch to
 	                             // tone pitch.
@@ -229,7 +232,7 @@ public:
 	Seq();
 
 	static const unsigned size = 16;
-	std::vector<State> states;   // Array of sequencer states
+	State states[size];          // Array of sequencer states
 	Mode mode;                   // Sequencer mode
 	float tempo;                 // Tempo used to calculate the frequency
 	bool host_sync;              // Where the tempo is determined by the host
@@ -0,0 +1,195 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    pcmsink.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "pcmsink.hpp"
+
+using namespace zynayumi;
+
+namespace {
+
+const unsigned CHANNEL_COUNT = 2;
+
+// WAV format tags
+const uint16_t WAVE_FORMAT_PCM = 1;
+const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+
+// Size of the WAV header in bytes, float data requiring an extended
+// fmt chunk and a fact chunk
+unsigned header_size(SampleFormat format)
+{
+	return format == SampleFormat::Float32 ? 58 : 44;
+}
+
+// Append little endian integers
+void put_u16(unsigned char*& p, uint16_t v)
+{
+	*p++ = v & 0xff;
+	*p++ = v >> 8;
+}
+
+void put_u32(unsigned char*& p, uint32_t v)
+{
+	put_u16(p, v & 0xffff);
+	put_u16(p, v >> 16);
+}
+
+void put_tag(unsigned char*& p, const char* tag)
+{
+	std::copy(tag, tag + 4, p);
+	p += 4;
+}
+
+} // ~namespace
+
+unsigned zynayumi::sample_size(SampleFormat format)
+{
+	return format == SampleFormat::Int16 ? sizeof(int16_t) : sizeof(float);
+}
+
+PcmSink::PcmSink(SampleFormat format) : _format(format) {}
+
+PcmSink::~PcmSink() {}
+
+SampleFormat PcmSink::get_format() const
+{
+	return _format;
+}
+
+void PcmSink::interleave(const float* left, const float* right,
+                         unsigned long count, SampleFormat format,
+                         void* out)
+{
+	if (format == SampleFormat::Int16) {
+		int16_t* o = static_cast<int16_t*>(out);
+		for (unsigned long i = 0; i < count; i++) {
+			*o++ = std::lrint(std::clamp(left[i], -1.0f, 1.0f) * 32767.0f);
+			*o++ = std::lrint(std::clamp(right[i], -1.0f, 1.0f) * 32767.0f);
+		}
+	} else {
+		float* o = static_cast<float*>(out);
+		for (unsigned long i = 0; i < count; i++) {
+			*o++ = left[i];
+			*o++ = right[i];
+		}
+	}
+}
+
+CallbackSink::CallbackSink(SampleFormat format, const Callback& callback)
+	: PcmSink(format), _callback(callback) {}
+
+bool CallbackSink::write(const void* frames, unsigned long count)
+{
+	return _callback(frames, count);
+}
+
+WavWriter::WavWriter(SampleFormat format)
+	: PcmSink(format), _file(nullptr), _sample_rate(0), _frame_count(0),
+	  _overflow(false) {}
+
+WavWriter::~WavWriter()
+{
+	close();
+}
+
+bool WavWriter::open(const std::string& path, int sample_rate)
+{
+	close();
+	_file = std::fopen(path.c_str(), "wb");
+	_sample_rate = sample_rate;
+	_frame_count = 0;
+	_overflow = false;
+	return _file and write_header();
+}
+
+bool WavWriter::close()
+{
+	if (not _file)
+		return true;
+	bool success = std::fseek(_file, 0, SEEK_SET) == 0 and write_header();
+	success = std::fclose(_file) == 0 and success;
+	_file = nullptr;
+	return success and not _overflow;
+}
+
+bool WavWriter::write(const void* frames, unsigned long count)
+{
+	if (not _file)
+		return false;
+
+	// Fail rather than wrap the sizes in the header
+	if (_overflow or max_frame_count() - _frame_count < count) {
+		_overflow = true;
+		return false;
+	}
+	const unsigned frame_size = CHANNEL_COUNT * sample_size(get_format());
+	_frame_count += count;
+	return std::fwrite(frames, frame_size, count, _file) == count;
+}
+
+unsigned long WavWriter::max_frame_count() const
+{
+	// The RIFF chunk size, covering the whole file but its first 8
+	// bytes, is the largest
+	const unsigned frame_size = CHANNEL_COUNT * sample_size(get_format());
+	return (UINT32_MAX - (header_size(get_format()) - 8)) / frame_size;
+}
+
+bool WavWriter::write_header()
+{
+	// Float data requires an extended fmt chunk and a fact chunk
+	const bool is_float = get_format() == SampleFormat::Float32;
+	const unsigned bytes = sample_size(get_format());
+	const uint32_t data_size = _frame_count * CHANNEL_COUNT * bytes;
+	const uint32_t fmt_size = is_float ? 18 : 16;
+	const uint32_t fact_size = is_float ? 12 : 0;
+
+	unsigned char header[58];
+	unsigned char* p = header;
+	put_tag(p, "RIFF");
+	put_u32(p, 4 + 8 + fmt_size + fact_size + 8 + data_size);
+	put_tag(p, "WAVE");
+	put_tag(p, "fmt ");
+	put_u32(p, fmt_size);
+	put_u16(p, is_float ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+	put_u16(p, CHANNEL_COUNT);
+	put_u32(p, _sample_rate);
+	put_u32(p, _sample_rate * CHANNEL_COUNT * bytes);
+	put_u16(p, CHANNEL_COUNT * bytes);
+	put_u16(p, 8 * bytes);
+	if (is_float) {
+		put_u16(p, 0);
+		put_tag(p, "fact");
+		put_u32(p, 4);
+		put_u32(p, _frame_count);
+	}
+	put_tag(p, "data");
+	put_u32(p, data_size);
+
+	const size_t size = p - header;
+	return std::fwrite(header, 1, size, _file) == size;
+}
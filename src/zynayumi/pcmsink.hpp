@@ -0,0 +1,130 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    pcmsink.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_PCMSINK_HPP
+#define __ZYNAYUMI_PCMSINK_HPP
+
+#include <cstdio>
+#include <functional>
+#include <string>
+
+namespace zynayumi {
+
+// Sample formats of the rendered PCM
+enum class SampleFormat {
+	Float32,
+	Int16,
+
+	Count
+};
+
+// Return the size in bytes of a sample
+unsigned sample_size(SampleFormat format);
+
+/**
+ * Receiver of rendered audio, as interleaved stereo frames.
+ */
+class PcmSink {
+public:
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	PcmSink(SampleFormat format);
+	virtual ~PcmSink();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	SampleFormat get_format() const;
+
+	// Receive count interleaved stereo frames, of float or int16_t
+	// according to the format. Return false on failure.
+	virtual bool write(const void* frames, unsigned long count) = 0;
+
+	// Interleave count frames of left and right into out, converting
+	// them to format. Int16 samples are clipped and rounded.
+	static void interleave(const float* left, const float* right,
+	                       unsigned long count, SampleFormat format,
+	                       void* out);
+
+private:
+	SampleFormat _format;
+};
+
+/**
+ * Sink forwarding frames to a callback.
+ */
+class CallbackSink : public PcmSink {
+public:
+	typedef std::function<bool(const void* frames, unsigned long count)> Callback;
+
+	CallbackSink(SampleFormat format, const Callback& callback);
+
+	bool write(const void* frames, unsigned long count) override;
+
+private:
+	Callback _callback;
+};
+
+/**
+ * Sink writing a WAV file, 16 bit PCM or 32 bit float. The sizes in
+ * the header are filled in by close, also called by the destructor.
+ * As they are 32 bit, the file is limited to 4 GiB, beyond which
+ * write and close fail.
+ */
+class WavWriter : public PcmSink {
+public:
+	WavWriter(SampleFormat format);
+	~WavWriter();
+
+	// Create the file and write a header. Return false on failure.
+	bool open(const std::string& path, int sample_rate);
+
+	// Fill in the sizes in the header and close the file. Return false
+	// on failure, including if a write exceeded the size limit.
+	bool close();
+
+	bool write(const void* frames, unsigned long count) override;
+
+private:
+	bool write_header();
+
+	// Maximum number of frames such that the sizes in the header fit
+	// in 32 bit
+	unsigned long max_frame_count() const;
+
+	std::FILE* _file;
+	int _sample_rate;
+	unsigned long _frame_count;
+
+	// True iff a write was refused for exceeding max_frame_count
+	bool _overflow;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -0,0 +1,51 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    pitchtable.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#include <cmath>
+
+#include "pitchtable.hpp"
+
+using namespace zynayumi;
+
+PitchTable::PitchTable() : _coef(0.0)
+{
+	configure(1.0);
+}
+
+void PitchTable::configure(double coef)
+{
+	if (coef == _coef)
+		return;
+
+	_coef = coef;
+	for (int k = 0; k < STEPS_PER_OCTAVE; k++)
+		_table[k] = coef * std::exp2((double)k / STEPS_PER_OCTAVE);
+}
+
+long PitchTable::exp_rounded_period(double pitch) const
+{
+	static const double coef = std::log(2.0) / 12.0;
+	return std::lround(_coef * std::exp(-pitch * coef));
+}
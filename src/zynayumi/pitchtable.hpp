@@ -0,0 +1,136 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    pitchtable.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#ifndef __ZYNAYUMI_PITCHTABLE_HPP
+#define __ZYNAYUMI_PITCHTABLE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace zynayumi {
+
+/**
+ * Table-driven calculation of coef * 2^(-pitch/12), used to convert
+ * pitches into YM2149 tone and envelope periods without calling exp.
+ *
+ * The table covers one octave at a fine resolution, the remaining
+ * fraction of step is handled by a short polynomial and the octave by
+ * shifting the exponent, so that the relative error stays within a few
+ * ulps.
+ */
+class PitchTable {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Resolution of the table, a bit more than 85 steps per semitone
+	static const int OCTAVE_BITS = 10;
+	static const int STEPS_PER_OCTAVE = 1 << OCTAVE_BITS;
+
+	// log(2) / STEPS_PER_OCTAVE
+	static constexpr double STEP_LOG = 6.769015435155716e-04;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	PitchTable();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Set the period of pitch 0 and rebuild the table if it has
+	// changed
+	void configure(double coef);
+
+	// Return coef * 2^(-pitch/12)
+	double period(double pitch) const;
+
+	// Return coef * exp(-pitch * log(2) / 12) rounded to the nearest
+	// integer. Bit compatible with the exp based calculation, which is
+	// used as fall back when the result is too close to a rounding
+	// boundary.
+	long rounded_period(double pitch) const;
+
+private:
+	// Rounded period calculated with exp, as fall back of
+	// rounded_period.
+	long exp_rounded_period(double pitch) const;
+
+	double _coef;
+
+	// _table[k] = coef * 2^(k / STEPS_PER_OCTAVE)
+	double _table[STEPS_PER_OCTAVE];
+};
+
+// Defined inline as it is called for every voice at control rate
+inline double PitchTable::period(double pitch) const
+{
+	// Decompose -pitch in steps as octave, table index and fraction
+	double x = -pitch * (STEPS_PER_OCTAVE / 12.0);
+	int64_t n = (int64_t)x;
+	n -= x < n;                 // Floor
+	double f = (x - n) * STEP_LOG;
+	int64_t octave = n >> OCTAVE_BITS;
+	int64_t k = n & (STEPS_PER_OCTAVE - 1);
+
+	// exp(f) for f within [0, log(2) / STEPS_PER_OCTAVE), the
+	// truncation error is below 1e-18.
+	double e = 1.0 + f * (1.0 + f * (0.5 + f * (1.0 / 6.0 + f * (1.0 / 24.0))));
+
+	// Multiply by 2^octave by adding octave to the exponent
+	double p = _table[k] * e;
+	uint64_t bits;
+	std::memcpy(&bits, &p, sizeof(bits));
+	bits += (uint64_t)octave << 52;
+	std::memcpy(&p, &bits, sizeof(p));
+	return p;
+}
+
+inline long PitchTable::rounded_period(double pitch) const
+{
+	// Relative distance to a rounding boundary under which the
+	// approximation may round differently than exp.
+	static const double tolerance = 1e-12;
+
+	// Periods are positive so rounding boils down to a truncation,
+	// ties being dealt with by the fall back.
+	double p = period(pitch);
+	long r = (long)(p + 0.5);
+	double d = p - r;
+	if (d < 0)
+		d = -d;
+	d -= 0.5;
+	if (-tolerance * p < d and d < tolerance * p)
+		return exp_rounded_period(pitch);
+	return r;
+}
+
+} // ~namespace zynayumi
+
+#endif
@@ -25,6 +25,7 @@
 #include "programs.hpp"
 #include "parameters.hpp"
 #include "patch.hpp"
+#include "zynayumi.hpp"
 
 namespace zynayumi {
 
@@ -630,6 +631,18 @@ Programs::~Programs()
 {
 }
 
+Patch Programs::get_patch(unsigned index)
+{
+	Zynayumi zynayumi;
+	Parameters parameters(zynayumi, zynayumi.patch);
+	if (index < count) {
+		Programs programs(zynayumi);
+		parameters = *programs.parameters_pts[index];
+	}
+	parameters.update();
+	return zynayumi.patch;
+}
+
 // Just to remember it
 
 // // Power bass
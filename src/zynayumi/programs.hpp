@@ -34,6 +34,11 @@ public:
 	Programs(Zynayumi& zynayumi);
 	~Programs();
 
+	// Return a copy of the patch of program index, or of the default
+	// patch if there is no such program, built on a Zynayumi instance
+	// of its own so that it can be used concurrently.
+	static Patch get_patch(unsigned index);
+
 	static const unsigned count = 3;
 	Patch patches[count];
 	Parameters* parameters_pts[count];
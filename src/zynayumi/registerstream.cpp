@@ -0,0 +1,435 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    registerstream.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "registerstream.hpp"
+#include "engine.hpp"
+
+using namespace zynayumi;
+
+namespace {
+
+// Append little endian integers
+void put_u16(uint8_t*& p, uint16_t v)
+{
+	*p++ = v & 0xff;
+	*p++ = v >> 8;
+}
+
+void put_u32(uint8_t*& p, uint32_t v)
+{
+	put_u16(p, v & 0xffff);
+	put_u16(p, v >> 16);
+}
+
+// Read little endian integers
+uint16_t get_u16(const uint8_t* p)
+{
+	return p[0] | p[1] << 8;
+}
+
+uint32_t get_u32(const uint8_t* p)
+{
+	return get_u16(p) | (uint32_t)get_u16(p + 2) << 16;
+}
+
+const uint16_t ENVELOPE_SHAPE_MASK = 1 << 13;
+const uint16_t REGISTERS_MASK = (1 << Chip::REGISTER_COUNT) - 1;
+
+} // ~namespace
+
+RegisterCapture::RegisterCapture()
+	: _file(nullptr)
+	, _success(false)
+	, _frame_rate(PAL_FRAME_RATE)
+	, _position(0)
+	, _frame_count(0)
+	, _chip_count(0)
+	, _is_ym2149(true)
+	, _clock_rate(0)
+{
+}
+
+RegisterCapture::~RegisterCapture()
+{
+	close();
+}
+
+bool RegisterCapture::open(const std::string& path, double frame_rate)
+{
+	close();
+	_file = std::fopen(path.c_str(), "wb");
+	_frame_rate = frame_rate;
+	_position = 0;
+	_frame_count = 0;
+	_chip_count = 0;
+	_registers.clear();
+	_envelope_shape_writes.clear();
+	_success = _file and 0.0 < frame_rate and write_header();
+	return _success;
+}
+
+bool RegisterCapture::close()
+{
+	if (not _file)
+		return true;
+	bool success = _success and std::fseek(_file, 0, SEEK_SET) == 0
+		and write_header();
+	success = std::fclose(_file) == 0 and success;
+	_file = nullptr;
+	return success;
+}
+
+unsigned long RegisterCapture::get_remaining(int sample_rate) const
+{
+	unsigned long long end = get_frame_end(sample_rate);
+	return _position < end ? end - _position : 1;
+}
+
+void RegisterCapture::process(const Engine& engine, unsigned long count)
+{
+	if (not _file)
+		return;
+	_position += count;
+	while (get_frame_end(engine.sample_rate) <= _position)
+		write_frame(engine);
+}
+
+unsigned long RegisterCapture::get_frame_count() const
+{
+	return _frame_count;
+}
+
+unsigned long long RegisterCapture::get_frame_end(int sample_rate) const
+{
+	return std::llround((_frame_count + 1) * (sample_rate / _frame_rate));
+}
+
+void RegisterCapture::write_frame(const Engine& engine)
+{
+	// Set the chips of the stream on the first frame
+	if (_frame_count == 0) {
+		_chip_count = engine.chips.size();
+		_is_ym2149 = engine.emulmode == EmulMode::YM2149;
+		_clock_rate = engine.clock_rate;
+		_registers.assign(_chip_count * Chip::REGISTER_COUNT, 0);
+		_envelope_shape_writes.assign(_chip_count, 0);
+	}
+
+	uint8_t frame[Engine::MAX_CHIPS * (2 + Chip::REGISTER_COUNT)];
+	uint8_t* p = frame;
+	for (unsigned i = 0; i < _chip_count; i++) {
+		// Chips removed since the first frame are silent
+		uint8_t registers[Chip::REGISTER_COUNT] = {};
+		unsigned long envelope_shape_writes = _envelope_shape_writes[i];
+		if (i < engine.chips.size()) {
+			const Chip& chip = engine.chips[i];
+			chip.get_registers(registers);
+			envelope_shape_writes =
+				chip.get_write_count(Chip::Register::EnvelopeShape);
+		}
+
+		// Write all registers on the first frame, then only those that
+		// changed, and the envelope shape whenever it was set
+		uint8_t* last = &_registers[i * Chip::REGISTER_COUNT];
+		uint16_t mask = 0;
+		for (int r = 0; r < Chip::REGISTER_COUNT; r++)
+			if (_frame_count == 0 or registers[r] != last[r])
+				mask |= 1 << r;
+		if (envelope_shape_writes != _envelope_shape_writes[i])
+			mask |= ENVELOPE_SHAPE_MASK;
+		put_u16(p, mask);
+		for (int r = 0; r < Chip::REGISTER_COUNT; r++)
+			if (mask & 1 << r)
+				*p++ = registers[r];
+
+		std::copy(registers, registers + Chip::REGISTER_COUNT, last);
+		_envelope_shape_writes[i] = envelope_shape_writes;
+	}
+
+	const size_t size = p - frame;
+	_success = _success and std::fwrite(frame, 1, size, _file) == size;
+	_frame_count++;
+}
+
+bool RegisterCapture::write_header()
+{
+	uint8_t header[REGISTER_STREAM_HEADER_SIZE];
+	uint8_t* p = header;
+	p = std::copy_n("ZYRS", 4, p);
+	*p++ = REGISTER_STREAM_VERSION;
+	*p++ = _chip_count;
+	*p++ = _is_ym2149 ? 0 : 1;
+	*p++ = 0;
+	put_u32(p, _clock_rate);
+	put_u32(p, std::lround(_frame_rate * 1000.0));
+	put_u32(p, _frame_count);
+	return std::fwrite(header, 1, sizeof(header), _file) == sizeof(header);
+}
+
+RegisterStream::RegisterStream()
+	: _data(nullptr)
+	, _size(0)
+	, _mapped(false)
+	, _chip_count(0)
+	, _is_ym2149(true)
+	, _clock_rate(0)
+	, _frame_rate(0.0)
+	, _frame_count(0)
+{
+}
+
+RegisterStream::~RegisterStream()
+{
+	close();
+}
+
+bool RegisterStream::open(const std::string& path)
+{
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &st) == 0 and 0 < st.st_size)
+		data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+		return false;
+	_data = static_cast<const uint8_t*>(data);
+	_size = st.st_size;
+	_mapped = true;
+	if (read_header())
+		return true;
+	close();
+	return false;
+}
+
+bool RegisterStream::assign(const uint8_t* data, size_t size)
+{
+	close();
+	_data = data;
+	_size = size;
+	if (read_header())
+		return true;
+	close();
+	return false;
+}
+
+void RegisterStream::close()
+{
+	if (_mapped)
+		munmap(const_cast<uint8_t*>(_data), _size);
+	_data = nullptr;
+	_size = 0;
+	_mapped = false;
+	_chip_count = 0;
+	_frame_count = 0;
+}
+
+unsigned RegisterStream::get_chip_count() const
+{
+	return _chip_count;
+}
+
+bool RegisterStream::is_ym2149() const
+{
+	return _is_ym2149;
+}
+
+int RegisterStream::get_clock_rate() const
+{
+	return _clock_rate;
+}
+
+double RegisterStream::get_frame_rate() const
+{
+	return _frame_rate;
+}
+
+unsigned long RegisterStream::get_frame_count() const
+{
+	return _frame_count;
+}
+
+const uint8_t* RegisterStream::get_frames_begin() const
+{
+	return _data + REGISTER_STREAM_HEADER_SIZE;
+}
+
+const uint8_t* RegisterStream::get_frames_end() const
+{
+	return _data + _size;
+}
+
+bool RegisterStream::read_header()
+{
+	if (not _data or _size < REGISTER_STREAM_HEADER_SIZE
+	    or not std::equal(_data, _data + 4, "ZYRS")
+	    or _data[4] != REGISTER_STREAM_VERSION)
+		return false;
+	_chip_count = _data[5];
+	_is_ym2149 = (_data[6] & 1) == 0;
+	_clock_rate = get_u32(_data + 8);
+	_frame_rate = get_u32(_data + 12) / 1000.0;
+	_frame_count = get_u32(_data + 16);
+	return 0 < _chip_count and 0 < _clock_rate and 0.0 < _frame_rate;
+}
+
+RegisterPlayer::RegisterPlayer(const RegisterStream& stream)
+	: loop(false)
+	, _stream(&stream)
+	, _registers(stream.get_chip_count() * Chip::REGISTER_COUNT, 0)
+	, _masks(stream.get_chip_count(), 0)
+{
+	rewind();
+}
+
+const RegisterStream& RegisterPlayer::get_stream() const
+{
+	return *_stream;
+}
+
+void RegisterPlayer::rewind()
+{
+	_cursor = _stream->get_frames_begin();
+	_position = 0;
+	_frame_count = 0;
+	_finished = false;
+	refresh();
+}
+
+void RegisterPlayer::refresh()
+{
+	// The envelope shape is restored by Chip::configure
+	std::fill(_masks.begin(), _masks.end(), REGISTERS_MASK & ~ENVELOPE_SHAPE_MASK);
+}
+
+bool RegisterPlayer::is_finished() const
+{
+	return _finished;
+}
+
+unsigned long RegisterPlayer::get_remaining(int sample_rate) const
+{
+	unsigned long long start = get_frame_start(sample_rate);
+	return _position < start ? start - _position : 1;
+}
+
+void RegisterPlayer::process(std::vector<Chip>& chips, int sample_rate,
+                             unsigned long count)
+{
+	while (get_frame_start(sample_rate) <= _position) {
+		_frame_count++;
+		if (_finished)
+			continue;
+		if (read_frame())
+			continue;
+		if (loop) {
+			_cursor = _stream->get_frames_begin();
+			if (read_frame())
+				continue;
+		}
+
+		// End of the stream, mute the chips
+		_finished = true;
+		for (unsigned i = 0; i < _masks.size(); i++) {
+			std::fill_n(&_registers[i * Chip::REGISTER_COUNT + 8],
+			            Chip::CHANNEL_COUNT, 0);
+			_masks[i] |= 0x7 << 8;
+		}
+	}
+	write_registers(chips);
+	_position += count;
+}
+
+unsigned long long RegisterPlayer::get_frame_start(int sample_rate) const
+{
+	return std::llround(_frame_count * (sample_rate / _stream->get_frame_rate()));
+}
+
+bool RegisterPlayer::read_frame()
+{
+	// Check the whole frame first so that a truncated one is ignored
+	const uint8_t* end = _stream->get_frames_end();
+	const uint8_t* p = _cursor;
+	for (unsigned i = 0; i < _masks.size(); i++) {
+		if (end - p < 2)
+			return false;
+		uint16_t mask = get_u16(p) & REGISTERS_MASK;
+		p += 2 + __builtin_popcount(mask);
+	}
+	if (end < p)
+		return false;
+
+	for (unsigned i = 0; i < _masks.size(); i++) {
+		uint16_t mask = get_u16(_cursor) & REGISTERS_MASK;
+		_cursor += 2;
+		uint8_t* registers = &_registers[i * Chip::REGISTER_COUNT];
+		for (int r = 0; r < Chip::REGISTER_COUNT; r++)
+			if (mask & 1 << r)
+				registers[r] = *_cursor++;
+		_masks[i] |= mask;
+	}
+	return true;
+}
+
+void RegisterPlayer::write_registers(std::vector<Chip>& chips)
+{
+	unsigned count = std::min<size_t>(chips.size(), _masks.size());
+	for (unsigned i = 0; i < count; i++) {
+		uint16_t mask = _masks[i];
+		if (not mask)
+			continue;
+		const uint8_t* registers = &_registers[i * Chip::REGISTER_COUNT];
+		Chip& chip = chips[i];
+		for (int c = 0; c < Chip::CHANNEL_COUNT; c++) {
+			if (mask & 3 << (2 * c))
+				chip.set_tone(c, registers[2 * c]
+				              | (registers[2 * c + 1] & 0xf) << 8);
+			if (mask & (1 << 7 | 1 << (8 + c)))
+				chip.set_mixer(c, registers[7] >> c & 1,
+				               registers[7] >> (3 + c) & 1,
+				               registers[8 + c] >> 4 & 1);
+			if (mask & 1 << (8 + c))
+				chip.set_volume(c, registers[8 + c] & 0xf);
+		}
+		if (mask & 1 << 6)
+			chip.set_noise(registers[6]);
+		if (mask & 3 << 11)
+			chip.set_envelope(registers[11] | registers[12] << 8);
+		if (mask & ENVELOPE_SHAPE_MASK)
+			chip.set_envelope_shape(registers[13] & 0xf);
+		_masks[i] = 0;
+	}
+}
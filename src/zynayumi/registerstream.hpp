@@ -0,0 +1,271 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    registerstream.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+
+#ifndef __ZYNAYUMI_REGISTERSTREAM_HPP
+#define __ZYNAYUMI_REGISTERSTREAM_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "chip.hpp"
+
+namespace zynayumi {
+
+class Engine;
+
+/**
+ * Register stream format, a compact dump of the register writes of
+ * one or more chips at a fixed frame rate, to be played back on real
+ * hardware, in a tracker or by the engine.
+ *
+ * All integers are little endian. The header is
+ *
+ *   "ZYRS"          magic
+ *   u8              version, REGISTER_STREAM_VERSION
+ *   u8              number of chips
+ *   u8              flags, bit 0 set for AY-3-8910, YM2149 otherwise
+ *   u8              reserved, 0
+ *   u32             chip clock rate in Hz
+ *   u32             frame rate in mHz
+ *   u32             number of frames
+ *
+ * followed by the frames. Each frame holds, for each chip, a u16 mask
+ * of the written registers, bit n for register Rn, followed by their
+ * values in increasing register order. Only registers that changed
+ * since the previous frame are written, except R13, written whenever
+ * the envelope shape is, as that restarts the envelope.
+ */
+const uint8_t REGISTER_STREAM_VERSION = 1;
+const unsigned REGISTER_STREAM_HEADER_SIZE = 20;
+
+/**
+ * Capture of the registers of the chips of an engine into a register
+ * stream file, once per frame. Set it as Engine::register_capture,
+ * the engine then splits its blocks at frame boundaries and calls
+ * process after each of them. Writes to the file, so not real-time
+ * safe, meant for offline renders.
+ */
+class RegisterCapture {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static constexpr double PAL_FRAME_RATE = 50.0;
+	static constexpr double NTSC_FRAME_RATE = 60.0;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	RegisterCapture();
+	~RegisterCapture();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Create the file and reserve its header, capturing frame_rate
+	// frames per second. Return false on failure.
+	bool open(const std::string& path, double frame_rate = PAL_FRAME_RATE);
+
+	// Fill in the header and close the file. Return false on failure,
+	// including any failure to write a frame.
+	bool close();
+
+	// Number of host samples before the end of the current frame
+	unsigned long get_remaining(int sample_rate) const;
+
+	// Account for count host samples rendered by engine, count being
+	// at most get_remaining, and write the registers of its chips if
+	// that ends the current frame.
+	void process(const Engine& engine, unsigned long count);
+
+	unsigned long get_frame_count() const;
+
+private:
+	// Position in host samples of the end of the current frame
+	unsigned long long get_frame_end(int sample_rate) const;
+
+	// Write the registers of the chips of engine that changed since
+	// the last frame
+	void write_frame(const Engine& engine);
+
+	bool write_header();
+
+	std::FILE* _file;
+	bool _success;
+	double _frame_rate;
+
+	// Host samples since open, and frames written so far
+	unsigned long long _position;
+	unsigned long _frame_count;
+
+	// Chips of the stream, set at the first frame
+	unsigned _chip_count;
+	bool _is_ym2149;
+	int _clock_rate;
+
+	// Registers and envelope shape writes of each chip at the last
+	// frame
+	std::vector<uint8_t> _registers;
+	std::vector<unsigned long> _envelope_shape_writes;
+};
+
+/**
+ * Register stream read in place, from a memory mapped file or from
+ * memory owned by the caller, without copying its frames. Can be
+ * shared by several players.
+ */
+class RegisterStream {
+public:
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	RegisterStream();
+	~RegisterStream();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Map the file at path and read its header. Return false on
+	// failure.
+	bool open(const std::string& path);
+
+	// Read the header of the stream at data, which must remain valid
+	// until close. Return false on failure.
+	bool assign(const uint8_t* data, size_t size);
+
+	// Unmap the file, if any
+	void close();
+
+	unsigned get_chip_count() const;
+	bool is_ym2149() const;
+	int get_clock_rate() const;
+	double get_frame_rate() const;
+	unsigned long get_frame_count() const;
+
+	// Range of the frames
+	const uint8_t* get_frames_begin() const;
+	const uint8_t* get_frames_end() const;
+
+private:
+	bool read_header();
+
+	const uint8_t* _data;
+	size_t _size;
+	bool _mapped;
+
+	unsigned _chip_count;
+	bool _is_ym2149;
+	int _clock_rate;
+	double _frame_rate;
+	unsigned long _frame_count;
+};
+
+/**
+ * Playback of a register stream. Set it as Engine::register_player,
+ * the engine then follows the chips of the stream, splits its blocks
+ * at frame boundaries and calls process before each of them, driving
+ * ayumi with the registers of the frames instead of running the
+ * voices. Real-time safe.
+ */
+class RegisterPlayer {
+public:
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	// The stream must outlive the player
+	RegisterPlayer(const RegisterStream& stream);
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	const RegisterStream& get_stream() const;
+
+	// Restart from the first frame
+	void rewind();
+
+	// Write all registers on the next call of process, after ayumi
+	// has been reconfigured
+	void refresh();
+
+	// True iff the end of the stream has been reached without looping
+	bool is_finished() const;
+
+	// Number of host samples before the start of the next frame
+	unsigned long get_remaining(int sample_rate) const;
+
+	// Write the registers of the frames starting at the current
+	// position to chips, then account for count host samples, count
+	// being at most get_remaining.
+	void process(std::vector<Chip>& chips, int sample_rate,
+	             unsigned long count);
+
+	///////////////////
+	// Attributes    //
+	///////////////////
+
+	// Whether to restart from the first frame at the end of the
+	// stream, otherwise the chips are muted
+	bool loop;
+
+private:
+	// Position in host samples of the start of the next frame
+	unsigned long long get_frame_start(int sample_rate) const;
+
+	// Decode the next frame into _registers and _masks. Return false
+	// at the end of the stream, or if the frame is truncated.
+	bool read_frame();
+
+	// Write the registers of _masks to chips
+	void write_registers(std::vector<Chip>& chips);
+
+	const RegisterStream* _stream;
+	const uint8_t* _cursor;
+
+	// Host samples since the start, and frames read so far
+	unsigned long long _position;
+	unsigned long _frame_count;
+
+	bool _finished;
+
+	// Current registers of each chip, and mask of those to write
+	std::vector<uint8_t> _registers;
+	std::vector<uint16_t> _masks;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -0,0 +1,86 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    renderer.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+
+#include "renderer.hpp"
+
+using namespace zynayumi;
+
+template<typename T>
+Renderer<T>::Renderer()
+{
+	configure(1);
+}
+
+template<typename T>
+void Renderer<T>::configure(int oversampling)
+{
+	_decimator.configure(oversampling);
+	std::fill(std::begin(_dc_left), std::end(_dc_left), T(0));
+	std::fill(std::begin(_dc_right), std::end(_dc_right), T(0));
+	_dc_left_sum = 0.0;
+	_dc_right_sum = 0.0;
+	_dc_index = 0;
+	_dc_null_frames = DC_FILTER_SIZE;
+}
+
+template<typename T>
+void Renderer<T>::process(int count)
+{
+	_decimator.process_block(chip_left, chip_right, count,
+	                         block_left, block_right);
+	remove_dc(count);
+}
+
+template<typename T>
+void Renderer<T>::remove_dc(int count)
+{
+	int index = _dc_index;
+	for (int i = 0; i < count; i++) {
+		_dc_left_sum += -_dc_left[index] + block_left[i];
+		_dc_left[index] = block_left[i];
+		_dc_right_sum += -_dc_right[index] + block_right[i];
+		_dc_right[index] = block_right[i];
+		if (block_left[i] != T(0) or block_right[i] != T(0))
+			_dc_null_frames = 0;
+		else if (_dc_null_frames < DC_FILTER_SIZE
+		         and ++_dc_null_frames == DC_FILTER_SIZE) {
+			_dc_left_sum = 0.0;
+			_dc_right_sum = 0.0;
+		}
+		block_left[i] = block_left[i] - _dc_left_sum / DC_FILTER_SIZE;
+		block_right[i] = block_right[i] - _dc_right_sum / DC_FILTER_SIZE;
+		index = (index + 1) & (DC_FILTER_SIZE - 1);
+	}
+	_dc_index = index;
+}
+
+namespace zynayumi {
+
+template class Renderer<float>;
+template class Renderer<double>;
+
+} // ~namespace zynayumi
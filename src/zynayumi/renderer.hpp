@@ -0,0 +1,118 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    renderer.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_RENDERER_HPP
+#define __ZYNAYUMI_RENDERER_HPP
+
+#include "decimator.hpp"
+
+namespace zynayumi {
+
+// Precision of the samples rendered by the engine
+enum class Precision {
+	Double,
+	Single,
+
+	Count
+};
+
+/**
+ * Post processing of the chip output, decimation and DC removal, over
+ * blocks of samples of type T, float or double.
+ *
+ * Only samples are of type T. The running sums of the DC filter are
+ * kept in double since they accumulate over the whole stream, as are
+ * the chip and voice states, which hold long running phase and time
+ * counters.
+ */
+template<typename T>
+class Renderer {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Maximum number of frames processed at once
+	static const int BLOCK_SIZE = DecimatorBase::MAX_BLOCK_SIZE;
+
+	// Length of the DC filter, the same as ayumi's
+	static const int DC_FILTER_SIZE = 1024;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	Renderer();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Set the oversampling, within [1, DecimatorBase::MAX_FACTOR], and
+	// clear the filter states.
+	void configure(int oversampling);
+
+	// Decimate count * oversampling frames of chip_left and chip_right
+	// into count frames, at most BLOCK_SIZE, of block_left and
+	// block_right, then remove their DC.
+	void process(int count);
+
+	///////////////////
+	// Attributes    //
+	///////////////////
+
+	// Chip output of the current block, at the oversampled rate
+	T chip_left[BLOCK_SIZE * DecimatorBase::MAX_FACTOR];
+	T chip_right[BLOCK_SIZE * DecimatorBase::MAX_FACTOR];
+
+	// Decimated output of the current block
+	T block_left[BLOCK_SIZE];
+	T block_right[BLOCK_SIZE];
+
+private:
+	// Remove DC over the first count frames of block_left and
+	// block_right, equivalent to ayumi_remove_dc.
+	void remove_dc(int count);
+
+	// Low pass filter from the oversampled rate to the host rate
+	Decimator<T> _decimator;
+
+	// DC filter delay lines and their running sums
+	T _dc_left[DC_FILTER_SIZE];
+	T _dc_right[DC_FILTER_SIZE];
+	double _dc_left_sum;
+	double _dc_right_sum;
+	int _dc_index;
+
+	// Number of consecutive null frames entered into the DC filter,
+	// up to DC_FILTER_SIZE. Once reached the delay lines only hold
+	// zeros and the running sums are reset, clearing the residue left
+	// by rounding, so that silence comes out exactly null.
+	int _dc_null_frames;
+};
+
+} // ~namespace zynayumi
+
+#endif
@@ -0,0 +1,90 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    smoother.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "smoother.hpp"
+
+namespace zynayumi {
+
+std::string to_string(SmoothingMode sm)
+{
+	switch(sm) {
+	case SmoothingMode::Off:
+		return "Off";
+	case SmoothingMode::Linear:
+		return "Linear";
+	case SmoothingMode::OnePole:
+		return "One-pole";
+	default:
+		return "";
+	}
+}
+
+Smoother::Smoother()
+	: _mode(SmoothingMode::Off),
+	  _ramp_length(1),
+	  _coef(1.0),
+	  _value(0.0),
+	  _target(0.0),
+	  _step(0.0),
+	  _remaining(0)
+{
+}
+
+void Smoother::configure(SmoothingMode mode, double time, int sample_rate)
+{
+	_mode = mode;
+	double length = std::max(0.0, time * sample_rate);
+	_ramp_length = std::max(1, (int)std::lround(length));
+	_coef = 1.0 < length ? 1.0 - std::exp(-1.0 / length) : 1.0;
+	start_ramp();
+}
+
+void Smoother::reset(double value)
+{
+	_value = value;
+	_target = value;
+	_remaining = 0;
+}
+
+void Smoother::start_ramp()
+{
+	if (_mode == SmoothingMode::Linear and 1 < _ramp_length) {
+		_step = (_target - _value) / _ramp_length;
+		_remaining = _ramp_length;
+	} else if (_mode != SmoothingMode::OnePole) {
+		// Without ramp the target is reached at once
+		_value = _target;
+		_remaining = 0;
+	}
+}
+
+double Smoother::get_value() const
+{
+	return _value;
+}
+
+} // ~namespace zynayumi
@@ -0,0 +1,142 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    smoother.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_SMOOTHER_HPP
+#define __ZYNAYUMI_SMOOTHER_HPP
+
+#include <string>
+
+namespace zynayumi {
+
+enum class SmoothingMode {
+	Off,
+	Linear,
+	OnePole,
+
+	Count
+};
+
+std::string to_string(SmoothingMode sm);
+
+/**
+ * Smoothing of a continuous parameter, ramping toward its last value
+ * instead of jumping to it, so that automation does not cause zipper
+ * noise.
+ *
+ * Linear ramps reach the target in the smoothing time, starting over
+ * from the current value whenever the target changes. One-pole ramps
+ * approach the target exponentially, with the smoothing time as time
+ * constant, and snap to it once close enough. Once the target is
+ * reached the value is exactly the target.
+ */
+class Smoother {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Distance to the target under which one-pole ramps snap to it
+	static constexpr double EPSILON = 1e-6;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	Smoother();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Set the mode and the time of the ramps, in second, at the given
+	// sample rate. A ramp under way starts over from the current value.
+	void configure(SmoothingMode mode, double time, int sample_rate);
+
+	// Jump to value
+	void reset(double value);
+
+	// Ramp toward target over count samples, writing the value of each
+	// sample into values.
+	void process(double target, double* values, int count);
+
+	double get_value() const;
+
+private:
+	// Start ramping from the current value toward _target
+	void start_ramp();
+
+	SmoothingMode _mode;
+
+	// Length of linear ramps, in samples
+	int _ramp_length;
+
+	// Coefficient of one-pole ramps
+	double _coef;
+
+	double _value;
+	double _target;
+
+	// Increment of the linear ramp and its number of remaining samples
+	double _step;
+	int _remaining;
+};
+
+// Defined inline as it is called for every smoothed parameter at every
+// block
+inline void Smoother::process(double target, double* values, int count)
+{
+	if (target != _target) {
+		_target = target;
+		start_ramp();
+	}
+
+	if (_value == _target) {
+		for (int i = 0; i < count; i++)
+			values[i] = _value;
+		return;
+	}
+
+	if (_mode == SmoothingMode::OnePole) {
+		for (int i = 0; i < count; i++) {
+			_value += _coef * (_target - _value);
+			if (-EPSILON < _target - _value and _target - _value < EPSILON)
+				_value = _target;
+			values[i] = _value;
+		}
+	} else {
+		for (int i = 0; i < count; i++) {
+			if (0 < _remaining) {
+				_value += _step;
+				if (--_remaining == 0)
+					_value = _target;
+			}
+			values[i] = _value;
+		}
+	}
+}
+
+} // ~namespace zynayumi
+
+#endif
@@ -24,14 +24,30 @@
 
 #include <algorithm>
 #include <cmath>
-#include <iostream>
 
 #include "voice.hpp"
 #include "engine.hpp"
 
 using namespace zynayumi;
 
-Voice::Voice(Engine& engine, const Patch& pa, unsigned char ych)
+namespace {
+
+// One cycle of sine, with an extra point to interpolate the last
+// segment
+struct SineTable {
+	double values[Voice::LFO_SINE_TABLE_SIZE + 1];
+
+	SineTable() {
+		for (int i = 0; i <= Voice::LFO_SINE_TABLE_SIZE; i++)
+			values[i] = sin(2 * M_PI * i / Voice::LFO_SINE_TABLE_SIZE);
+	}
+};
+
+const SineTable lfo_sine_table;
+
+} // ~namespace
+
+Voice::Voice(Engine& engine, const Patch& pa, Chip& chip, unsigned char ych)
 	: enabled(true)
 	, ym_channel(ych)
 	, pitch(0)
@@ -40,23 +56,51 @@ Voice::Voice(Engine& engine, const Patch& pa, unsigned char ych)
 	, note_on(true)
 	, _engine(&engine)
 	, _patch(&pa)
+	, _chip(&chip)
 	, _initial_pitch(0)
+	, _final_pitch(0.0)
+	, _tone_off(true)
+	, _noise_off(true)
+	, _buzzer_off(true)
+	, _noise_period(0)
+	, _relative_pitchenv_pitch(0.0)
+	, _pitchenv_dirty(true)
+	, _relative_port_pitch(0.0)
+	, _port_pitch_diff(0.0)
+	, _port_end_time(0.0)
+	, _port_smoothness(0.0)
+	, _port_dirty(true)
+	, _relative_lfo_pitch(0.0)
+	, _lfo_phase(0.0)
+	, _lfo_cycle(0)
+	, _lfo_time(0.0)
 	, _seq_step(-1)
 	, _seq_change(true)
 	, _seq_index(0)
 	, _seq_level(1.0)
 	, _relative_seq_pitch(0)
-	, _seq_rnd_offset_step(rand())
+	, _seq_rnd_offset_step(engine.random())
 	, _rnd_index(-1)
 	, _env_smp_count(0)
 	, _on_smp_count(0)
 	, _pitch_smp_count(0)
+	, _final_level(0.0)
 	, _ringmod_smp_count(0)
 	, _ringmod_back(false)
 	, _ringmod_waveform_index(0)
+	, _ringmod_waveform_level(0.0)
+	, _ringmod_pitch(0.0)
+	, _ringmod_smp_period(0.0)
+	, _ringmod_whole_smp_period(0.0)
+	, _ringmod_depth(0.0)
+	, _buzzer_pitch(0.0)
+	, _buzzer_period(0)
+	, _actual_sustain_level(0.0)
+	, _env_dirty(true)
 	, _first_update(true)
+	, _control_countdown(0)
 	, _tone_trigger(false)
-	, _last_tone(_engine->ay.channels[ym_channel].tone)
+	, _last_tone(_chip->ay.channels[ym_channel].tone)
 {
 	silence();
 }
@@ -78,12 +122,14 @@ void Voice::set_note_pitch(unsigned char pi)
 	pitch = pi;
 	_initial_pitch = pi;
 	_pitch_smp_count = 0;
+	_control_countdown = 0;
 }
 
 void Voice::set_velocity(unsigned char vel)
 {
 	velocity = vel;
 	velocity_level = velocity_to_level(_patch->control.velocity_sensitivity, velocity);
+	_control_countdown = 0;
 }
 
 void Voice::set_note_off()
@@ -91,6 +137,8 @@ void Voice::set_note_off()
 	note_on = false;
 	_env_smp_count = 0;
 	_actual_sustain_level = env_level;
+	_env_dirty = true;
+	_control_countdown = 0;
 }
 
 void Voice::retrig()
@@ -100,17 +148,21 @@ void Voice::retrig()
 	_seq_change = true;
 	_seq_index = 0;
 	_relative_seq_pitch = 0;
-	_seq_rnd_offset_step = rand(); // NEXT: replace all instances of
-	                               // rand() by hash or such
+	_seq_rnd_offset_step = _engine->random();
 	_rnd_index = -1;
 	_env_smp_count = 0;
+	_env_dirty = true;
 	_on_smp_count = 0;
+	_lfo_phase = 0.0;
+	_lfo_cycle = 0;
+	_lfo_time = 0.0;
 	_ringmod_smp_count = 0;
 	_ringmod_back = false;
 	_ringmod_waveform_index = 0;
 	_first_update = true;
+	_control_countdown = 0;
 	_tone_trigger = false;
-	_last_tone = _engine->ay.channels[ym_channel].tone;
+	_last_tone = _chip->ay.channels[ym_channel].tone;
 }
 
 void Voice::enable()
@@ -128,7 +180,16 @@ void Voice::silence()
 {
 	note_on = false;
 	env_level = 0.0;
-	ayumi_set_mixer(&_engine->ay, ym_channel, true, true, false);
+	_chip->set_mixer(ym_channel, true, true, false);
+}
+
+void Voice::refresh()
+{
+	if (is_silent())
+		_chip->set_mixer(ym_channel, true, true, false);
+	_control_countdown = 0;
+	_pitchenv_dirty = true;
+	_port_dirty = true;
 }
 
 bool Voice::is_silent() const
@@ -137,17 +198,30 @@ bool Voice::is_silent() const
 	return not note_on and env_level <= EPSILON;
 }
 
-void Voice::update()
+void Voice::update(int frame)
 {
 	if (is_silent())
 		return;
 
+	// Update modulators at control rate
+	if (_control_countdown == 0) {
+		update_control(frame);
+		_control_countdown = std::max(1, _engine->control_period);
+	}
+	_control_countdown--;
+
+	// Update ring modulation, sync and level at audio rate
+	update_audio();
+}
+
+void Voice::update_control(int frame)
+{
 	// Update time
 	on_time = _engine->smp2sec(_on_smp_count);
 	pitch_time = _engine->smp2sec(_pitch_smp_count);
 
 	// Update pan
-	update_pan();
+	update_pan(frame);
 
 	// Update seq
 	update_seq();
@@ -157,15 +231,15 @@ void Voice::update()
 	update_noise_off();
 	update_buzzer_off();
 	update_noise_period();
-	ayumi_set_noise(&_engine->ay, _noise_period);
-	ayumi_set_mixer(&_engine->ay, ym_channel, _tone_off, _noise_off, !_buzzer_off);
+	_chip->set_noise(_noise_period);
+	_chip->set_mixer(ym_channel, _tone_off, _noise_off, !_buzzer_off);
 
 	// Update pitch
 	update_pitchenv();
 	update_portamento();
-	update_lfo();
+	update_lfo(frame);
 	update_arp();
-	update_final_pitch();
+	update_final_pitch(frame);
 	update_tone();
 
 	// Reset
@@ -178,10 +252,24 @@ void Voice::update()
 			_tone_trigger = true;
 	}
 
+	// Update buzzer
+	update_buzzer();
+
+	// Update envelope, ring modulation period and depth, and
+	// sequencer level
+	update_env();
+	update_ringmod_pitch();
+	update_ringmod_smp_period();
+	update_ringmod_depth();
+	update_seq_level();
+}
+
+void Voice::update_audio()
+{
 	// Sync
 	if (_patch->ringmod.sync) {
 		// Update tone trigger
-		struct tone_channel& ch = _engine->ay.channels[ym_channel];
+		struct tone_channel& ch = _chip->ay.channels[ym_channel];
 		if (_last_tone != ch.tone) {
 			_tone_trigger = true;//(ch.tone == 1);
 			_last_tone = ch.tone;
@@ -198,19 +286,16 @@ void Voice::update()
 		}
 	}
 
-	// Update buzzer
-	update_buzzer();
-
 	// Update level, including ring modulation
-	update_env();
 	update_ringmod();
-	update_seq_level();
 	update_final_level();
-	ayumi_set_volume(&_engine->ay, ym_channel, std::lround(_final_level * MAX_LEVEL));
+	_chip->set_volume(ym_channel, std::lround(_final_level * MAX_LEVEL));
 
-	// Increment sample count since voice on or pitch change
+	// Increment sample count since voice on, pitch change or envelope
+	// change
 	_on_smp_count++;
 	_pitch_smp_count++;
+	_env_smp_count++;
 }
 
 double Voice::linear_interpolate(double x1, double y1,
@@ -300,9 +385,11 @@ double Voice::exponential_decay_interpolate(double x1, double y1,
 	return a + b*std::pow(e, -x);
 }
 
-void Voice::update_pan()
+void Voice::update_pan(int frame)
 {
-	ayumi_set_pan(&_engine->ay, ym_channel, _patch->mixer.pan[ym_channel], 0);
+	Engine::Smoothed pan = (Engine::Smoothed)((int)Engine::Smoothed::Pan0
+	                                          + ym_channel);
+	_chip->set_pan(ym_channel, _engine->get_smoothed(pan, frame));
 }
 
 void Voice::update_seq()
@@ -392,17 +479,19 @@ void Voice::update_seq()
 		break;
 	}
 	default:
-		std::cerr << "Case not implemented, there's likely a bug" << std::endl;
+		_engine->diagnostics.push(Diagnostics::Code::UnexpectedCase, __LINE__);
 		break;
 	}
 
-	std::cout << "Voice::update_seq() _seq_step = " << _seq_step << ", _seq_index = " << _seq_index << std::endl;
+	if (_engine->diagnostics.is_trace())
+		_engine->diagnostics.push(Diagnostics::Code::SeqStep,
+		                          ym_channel, _seq_step, _seq_index);
 }
 
 void Voice::update_tone()
 {
 	double tp = _engine->pitch2toneperiod(_final_pitch);
-	ayumi_set_tone(&_engine->ay, ym_channel, tp);
+	_chip->set_tone(ym_channel, tp);
 }
 
 void Voice::update_tone_off()
@@ -454,16 +543,23 @@ void Voice::update_noise_period()
 
 void Voice::update_pitchenv()
 {
-	double apitch = _patch->pitchenv.attack_pitch;
-	double ptime = _patch->pitchenv.time;
-	const double scale_L = 0.1;
-	const double scale_U = 1.0;
-	const double exponential = 2.0;
-	double scale = ptime *
-		exponential_decay_interpolate(0.0, scale_U, 1.0, scale_L,
-		                              _patch->pitchenv.smoothness, exponential);
+	// Reconfigure the curve only if the pitch envelope has changed
+	if (_pitchenv_dirty or not (_pitchenv_params == _patch->pitchenv)) {
+		_pitchenv_params = _patch->pitchenv;
+		_pitchenv_dirty = false;
+		double apitch = _patch->pitchenv.attack_pitch;
+		double ptime = _patch->pitchenv.time;
+		const double scale_L = 0.1;
+		const double scale_U = 1.0;
+		const double exponential = 2.0;
+		double scale = ptime *
+			exponential_decay_interpolate(0.0, scale_U, 1.0, scale_L,
+			                              _patch->pitchenv.smoothness, exponential);
+		_pitchenv_curve.configure(-ptime, 2.0*apitch, ptime, 0.0, scale,
+		                          _engine->sample_rate);
+	}
 	_relative_pitchenv_pitch = _patch->pitchenv.time < on_time ? 0.0
-		: logistic_interpolate(-ptime, 2.0*apitch, ptime, 0.0, on_time, scale);
+		: _pitchenv_curve(_on_smp_count);
 }
 
 void Voice::update_portamento()
@@ -472,50 +568,78 @@ void Voice::update_portamento()
 	double end_time = _patch->portamento.time + _engine->portamento_time;
 
 	if (0.0 < end_time) {
-		const double scale_L = 0.05;
-		const double scale_U = 400;
-		double scale = end_time *
-			linear_interpolate(0.0, scale_U, 1.0, scale_L,
-			                   _patch->portamento.smoothness);
+		// Reconfigure the curve only if the portamento has changed
+		if (_port_dirty or pitch_diff != _port_pitch_diff
+		    or end_time != _port_end_time
+		    or _patch->portamento.smoothness != _port_smoothness) {
+			_port_pitch_diff = pitch_diff;
+			_port_end_time = end_time;
+			_port_smoothness = _patch->portamento.smoothness;
+			_port_dirty = false;
+			const double scale_L = 0.05;
+			const double scale_U = 400;
+			double scale = end_time *
+				linear_interpolate(0.0, scale_U, 1.0, scale_L,
+				                   _patch->portamento.smoothness);
+			_port_curve.configure(0, pitch_diff, end_time, 0, scale,
+			                      _engine->sample_rate);
+		}
 		_relative_port_pitch =
 			(0 != pitch_diff and pitch_time < end_time ?
-			 logistic_interpolate(0, pitch_diff, end_time, 0, pitch_time, scale)
-			 : 0.0);
-		_engine->last_pitch = _relative_port_pitch + _initial_pitch;
-	} else {
-		_engine->last_pitch = _initial_pitch;
+			 _port_curve(_pitch_smp_count) : 0.0);
 	}
 
+	// Only the voices of the first chip keep track of the last pitch,
+	// which is enough for mono and unison modes, so that the other
+	// chips can be rendered concurrently.
+	if (_chip->index != 0)
+		return;
+	_engine->last_pitch = 0.0 < end_time ?
+		_relative_port_pitch + _initial_pitch : _initial_pitch;
+
 	// Make sure that increasing the portamento time once over doesn't
 	// retrigger it
 	if (end_time <= pitch_time)
 		_engine->previous_pitch = _engine->last_pitch;
 }
 
-void Voice::update_lfo()
+void Voice::update_lfo(int frame)
 {
-	double depth = _patch->lfo.delay < on_time ? _patch->lfo.depth
-		: linear_interpolate(0, 0, _patch->lfo.delay, _patch->lfo.depth, on_time);
+	double lfo_depth = _engine->get_smoothed(Engine::Smoothed::LfoDepth, frame);
+	double depth = _patch->lfo.delay < on_time ? lfo_depth
+		: linear_interpolate(0, 0, _patch->lfo.delay, lfo_depth, on_time);
 	depth += _engine->mw_depth;
-	double lfo_pitch;
+
+	// Advance the phase by the time elapsed since the last update
+	_lfo_phase += _patch->lfo.freq * (on_time - _lfo_time);
+	_lfo_time = on_time;
+	if (1.0 <= _lfo_phase) {
+		double cycles = std::floor(_lfo_phase);
+		_lfo_phase -= cycles;
+		_lfo_cycle += (uint32_t)cycles;
+	}
+
+	double lfo_pitch = 0.0;
 	switch (_patch->lfo.shape) {
 	case LFO::Shape::Sine:
-		lfo_pitch = lfo_sine_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_sine_pitch(_lfo_phase);
 		break;
 	case LFO::Shape::Triangle:
-		lfo_pitch = lfo_triangle_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_triangle_pitch(_lfo_phase);
 		break;
 	case LFO::Shape::DownSaw:
-		lfo_pitch = lfo_downsaw_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_downsaw_pitch(_lfo_phase);
 		break;
 	case LFO::Shape::UpSaw:
-		lfo_pitch = lfo_upsaw_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_upsaw_pitch(_lfo_phase);
 		break;
 	case LFO::Shape::Square:
-		lfo_pitch = lfo_square_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_square_pitch(_lfo_phase);
 		break;
 	case LFO::Shape::Random:
-		lfo_pitch = lfo_rand_pitch(_patch->lfo.freq, on_time);
+		lfo_pitch = lfo_rand_pitch(_lfo_phase, _lfo_cycle);
+		break;
+	default:
 		break;
 	}
 	_relative_lfo_pitch = depth * lfo_pitch;
@@ -537,14 +661,14 @@ void Voice::update_arp()
 		unsigned index = count2index(0, _engine->pitches.size());
 		if (down)
 			index = (_engine->pitches.size() - 1) - index;
-		return *std::next(_engine->pitches.begin(), index);
+		return _engine->pitches[index];
 	};
 	// Find the pitch of a pingpong arp
 	auto pingpong2pitch = [&](bool down) -> unsigned char {
 		int ps = _engine->pitches.size() - 1;
 		int step = (down ? 0 : ps) + _seq_step;
 		unsigned index = std::abs((step % (2 * ps)) - ps);
-		return *std::next(_engine->pitches.begin(), index);
+		return _engine->pitches[index];
 	};
 
 	// Like the above but return a random index and pitch
@@ -569,7 +693,7 @@ void Voice::update_arp()
 	};
 	auto count2rndpitch = [&]() -> unsigned char {
 		unsigned index = count2rndindex(_engine->pitches.size());
-		return *std::next(_engine->pitches.begin(), index);
+		return _engine->pitches[index];
 	};
 
 	// Take care of playmode arp
@@ -595,7 +719,7 @@ void Voice::update_arp()
 		_relative_seq_pitch = enable_arp ? count2rndpitch() - _initial_pitch : 0.0;
 		break;
 	default:
-		std::cerr << "Case not implemented, there's likely a bug" << std::endl;
+		_engine->diagnostics.push(Diagnostics::Code::UnexpectedCase, __LINE__);
 		break;
 	}
 
@@ -604,10 +728,10 @@ void Voice::update_arp()
 		_relative_seq_pitch += _patch->seq.states[_seq_index].tone_pitch;
 }
 
-void Voice::update_final_pitch()
+void Voice::update_final_pitch(int frame)
 {
 	_final_pitch = _initial_pitch
-		+ _patch->tone.detune
+		+ _engine->get_smoothed(Engine::Smoothed::ToneDetune, frame)
 		+ ym_channel_to_spread()
 		+ _relative_pitchenv_pitch
 		+ _relative_port_pitch
@@ -619,68 +743,47 @@ void Voice::update_final_pitch()
 void Voice::update_env()
 {
 	if (_buzzer_off) {
-		// Determine portion of the envelope to interpolate
-		double env_time = _engine->smp2sec(_env_smp_count);
-		double x1, y1, x2, y2;
-		if (note_on) {
-			double ta = _patch->env.attack_time;
-			double ta1 = ta + _patch->env.inter1_time;
-			double ta12 = ta1 + _patch->env.inter2_time;
-			double ta123 = ta12 + _patch->env.decay_time;
-			if (env_time <= ta) {
-				x1 = 0;
-				y1 = 0;
-				x2 = ta;
-				y2 = normalize_level(_patch->env.hold1_level);
-			} else if (env_time <= ta1) {
-				x1 = ta;
-				y1 = normalize_level(_patch->env.hold1_level);
-				x2 = ta1;
-				y2 = normalize_level(_patch->env.hold2_level);
-			} else if (env_time <= ta12) {
-				x1 = ta1;
-				y1 = normalize_level(_patch->env.hold2_level);
-				x2 = ta12;
-				y2 = normalize_level(_patch->env.hold3_level);
-			} else if (env_time <= ta123) {
-				x1 = ta12;
-				y1 = normalize_level(_patch->env.hold3_level);
-				x2 = ta123;
-				y2 = normalize_level(_patch->env.sustain_level);
-			} else {
-				x1 = ta123;
-				y1 = normalize_level(_patch->env.sustain_level);
-				x2 = x1 + 1;
-				y2 = y1;
-			}
-		} else {                    // Note off
-			if (env_time <= _patch->env.release) {
-				x1 = 0;
-				y1 = _actual_sustain_level;
-				x2 = _patch->env.release;
-				y2 = 0;
-			} else {
-				x1 = _patch->env.release;
-				y1 = 0;
-				x2 = x1 + 1;
-				y2 = 0;
-			}
-		}
+		// Rebuild the segments upon note on, note off or envelope change
+		if (_env_dirty or not (_env_params == _patch->env))
+			update_env_segments();
+
 		// Calculate the envelope level
-		env_level = std::clamp(linear_interpolate(x1, y1, x2, y2, env_time), 0.0, 1.0);
+		double env_time = _engine->smp2sec(_env_smp_count);
+		env_level = std::clamp(_env_segments(env_time), 0.0, 1.0);
 	} else {                     // Buzzer is on
 		env_level = note_on ? 1.0 : 0.0;
 	}
+}
 
-	// Increment the envelope sample count
-	_env_smp_count++;
+void Voice::update_env_segments()
+{
+	_env_params = _patch->env;
+	_env_dirty = false;
+	_env_segments.clear();
+	if (note_on) {
+		double ta = _patch->env.attack_time;
+		double ta1 = ta + _patch->env.inter1_time;
+		double ta12 = ta1 + _patch->env.inter2_time;
+		double ta123 = ta12 + _patch->env.decay_time;
+		double l1 = normalize_level(_patch->env.hold1_level);
+		double l2 = normalize_level(_patch->env.hold2_level);
+		double l3 = normalize_level(_patch->env.hold3_level);
+		double ls = normalize_level(_patch->env.sustain_level);
+		_env_segments.add(0, 0, ta, l1);
+		_env_segments.add(ta, l1, ta1, l2);
+		_env_segments.add(ta1, l2, ta12, l3);
+		_env_segments.add(ta12, l3, ta123, ls);
+		_env_segments.add(ta123, ls, ta123 + 1, ls);
+	} else {                    // Note off
+		double tr = _patch->env.release;
+		_env_segments.add(0, _actual_sustain_level, tr, 0);
+		_env_segments.add(tr, 0, tr + 1, 0);
+	}
 }
 
 void Voice::update_ringmod()
 {
 	// TODO: fix ringmod phasing issue with mono playmod
-	update_ringmod_pitch();
-	update_ringmod_smp_period();
 	update_ringmod_smp_count();
 	update_ringmod_waveform_level();
 }
@@ -711,7 +814,7 @@ void Voice::update_ringmod_smp_period()
 void Voice::update_ringmod_smp_count()
 {
 	// Update ringmod sample count and waveform index
-	_ringmod_smp_count += _engine->ay.step * DECIMATE_FACTOR;
+	_ringmod_smp_count += _engine->chip_step();
 	double smp_phase = _patch->ringmod.phase * _ringmod_whole_smp_period;
 	while (_ringmod_smp_period <= (_ringmod_smp_count + smp_phase)) {
 		_ringmod_smp_count -= _ringmod_smp_period;
@@ -748,7 +851,7 @@ void Voice::update_ringmod_waveform_index()
 			}
 			return;
 		default:
-			std::cerr << "Case not implemented, there's likely a bug" << std::endl;
+			_engine->diagnostics.push(Diagnostics::Code::UnexpectedCase, __LINE__);
 			break;
 		}
 	}
@@ -763,17 +866,20 @@ void Voice::update_ringmod_waveform_index()
 	}
 }
 
-void Voice::update_ringmod_waveform_level()
+void Voice::update_ringmod_depth()
 {
 	// Determine ringmod depth, according to fixed depth, velocity and sequencer
-	double depth = normalize_level(_patch->ringmod.depth);
-	depth *= velocity_to_depth(_patch->control.ringmod_velocity_sensitivity, velocity);
+	_ringmod_depth = normalize_level(_patch->ringmod.depth);
+	_ringmod_depth *= velocity_to_depth(_patch->control.ringmod_velocity_sensitivity, velocity);
 	if (0 <= _seq_index)
-		depth *= normalize_level(_patch->seq.states[_seq_index].ringmod_depth);
+		_ringmod_depth *= normalize_level(_patch->seq.states[_seq_index].ringmod_depth);
+}
 
+void Voice::update_ringmod_waveform_level()
+{
 	// Determine waveform level according to depth and waveform index
 	double wfl = normalize_level(_patch->ringmod.waveform[_ringmod_waveform_index]);
-	_ringmod_waveform_level = linear_interpolate(0.0, (1.0 - depth), 1.0, 1.0, wfl);
+	_ringmod_waveform_level = linear_interpolate(0.0, (1.0 - _ringmod_depth), 1.0, 1.0, wfl);
 }
 
 void Voice::update_buzzer()
@@ -781,7 +887,7 @@ void Voice::update_buzzer()
 	update_buzzer_shape();
 	update_buzzer_pitch();
 	update_buzzer_period();
-	ayumi_set_envelope(&_engine->ay, _buzzer_period);
+	_chip->set_envelope(_buzzer_period);
 }
 
 void Voice::update_buzzer_off()
@@ -804,8 +910,8 @@ void Voice::update_buzzer_period()
 
 void Voice::update_buzzer_shape()
 {
-	if (_patch->buzzer.shape != _engine->buzzershape
-	    or _patch->ringmod.loop != _engine->ringmodloop) {
+	if (_patch->buzzer.shape != _chip->buzzershape
+	    or _patch->ringmod.loop != _chip->ringmodloop) {
 		int ym_shape = 0;
 		switch(_patch->buzzer.shape) {
 		case Buzzer::Shape::DownSaw:
@@ -835,13 +941,12 @@ void Voice::update_buzzer_shape()
 			}
 			break;
 		default:
-			std::cerr << "Case not implemented, there's likely a bug" << std::endl;
+			_engine->diagnostics.push(Diagnostics::Code::UnexpectedCase, __LINE__);
 			break;
 		}
-		ayumi_set_envelope_shape(&_engine->ay, ym_shape);
-		_engine->ayenvshape = ym_shape;
-		_engine->buzzershape = _patch->buzzer.shape;
-		_engine->ringmodloop = _patch->ringmod.loop;
+		_chip->set_envelope_shape(ym_shape);
+		_chip->buzzershape = _patch->buzzer.shape;
+		_chip->ringmodloop = _patch->ringmod.loop;
 	}
 }
 
@@ -860,7 +965,7 @@ void Voice::reset_tone()
 	if (not _patch->tone.reset)
 		return;
 
-	struct tone_channel& ch = _engine->ay.channels[ym_channel];
+	struct tone_channel& ch = _chip->ay.channels[ym_channel];
 	double tp = ch.tone_period;
 	double wtp = 2 * tp;            // Whole tone period
 	double counter = std::round(_patch->tone.phase * wtp);
@@ -873,11 +978,6 @@ void Voice::reset_tone()
 	ch.tone_counter = counter;
 }
 
-float floatrand()
-{
-	return ((float)rand() / (float)RAND_MAX);
-}
-
 void Voice::reset_ringmod()
 {
 	// Make sure the ring modulation period is correct
@@ -885,7 +985,9 @@ void Voice::reset_ringmod()
 	update_ringmod_smp_period();
 
 	// Update ringmod count to be in sync
-	float init_phase = _patch->ringmod.reset ? 0.0f : floatrand();
+	// Random phase derived from the random offset of the voice
+	float init_phase = _patch->ringmod.reset ? 0.0f :
+		hash(_seq_rnd_offset_step) / 4294967296.0f;
 	_ringmod_smp_count = init_phase * _ringmod_whole_smp_period;
 }
 
@@ -898,7 +1000,7 @@ void Voice::reset_buzzer()
 	update_buzzer_shape();
 	update_buzzer_pitch();
 	update_buzzer_period();
-	_engine->ay.envelope_counter = std::lround(_buzzer_period * _patch->ringmod.phase);
+	_chip->ay.envelope_counter = std::lround(_buzzer_period * _patch->ringmod.phase);
 }
 
 void Voice::sync_ringmod()
@@ -919,7 +1021,7 @@ void Voice::sync_buzzer()
 	update_buzzer_shape();
 	update_buzzer_pitch();
 	update_buzzer_period();
-	_engine->ay.envelope_counter = std::lround(_buzzer_period * _patch->ringmod.phase);
+	_chip->ay.envelope_counter = std::lround(_buzzer_period * _patch->ringmod.phase);
 }
 
 double Voice::velocity_to_level(double velocity_sensitivity, unsigned char velocity)
@@ -934,67 +1036,53 @@ double Voice::velocity_to_depth(double velocity_sensitivity, unsigned char veloc
 	                          127.0 * 127.0, 1.0, (double)((int)velocity * (int)velocity));
 }
 
-double Voice::lfo_cycle_remainder(double freq, double time)
-{
-	// TODO: optimize by maintaining a lfo_time attribute instead.
-	double period = 1.0 / freq;
-	while (period < time)
-		time -= period;
-	return time;
-}
-
-double Voice::lfo_sine_pitch(double freq, double time)
+double Voice::lfo_sine_pitch(double phase)
 {
-	return sin(2 * M_PI * time * freq);
+	double x = phase * LFO_SINE_TABLE_SIZE;
+	int i = (int)x;
+	return linear_interpolate(i, lfo_sine_table.values[i],
+	                          i + 1, lfo_sine_table.values[i + 1], x);
 }
 
-double Voice::lfo_triangle_pitch(double freq, double time)
+double Voice::lfo_triangle_pitch(double phase)
 {
-	double period = 1.0 /freq;
-	double half_period = period / 2.0;
-	double quater_period = half_period / 2.0;
-	time += quater_period;       // dephase to start at zero
-	time = lfo_cycle_remainder(freq, time);
-	if (time < half_period)
-		return linear_interpolate(0.0, -1.0, half_period, 1.0, time);
+	phase += 0.25;              // dephase to start at zero
+	if (1.0 <= phase)
+		phase -= 1.0;
+	if (phase < 0.5)
+		return linear_interpolate(0.0, -1.0, 0.5, 1.0, phase);
 	else
-		return linear_interpolate(half_period, 1.0, period, -1.0, time);
+		return linear_interpolate(0.5, 1.0, 1.0, -1.0, phase);
 }
 
-double Voice::lfo_downsaw_pitch(double freq, double time)
+double Voice::lfo_downsaw_pitch(double phase)
 {
-	double period = 1.0 /freq;
-	double half_period = period / 2.0;
-	time += half_period;       // dephase to start at zero
-	time = lfo_cycle_remainder(freq, time);
-	return linear_interpolate(0.0, 1.0, period, -1.0, time);
+	phase += 0.5;               // dephase to start at zero
+	if (1.0 <= phase)
+		phase -= 1.0;
+	return linear_interpolate(0.0, 1.0, 1.0, -1.0, phase);
 }
 
-double Voice::lfo_upsaw_pitch(double freq, double time)
+double Voice::lfo_upsaw_pitch(double phase)
 {
-	double period = 1.0 /freq;
-	double half_period = period / 2.0;
-	time += half_period;       // dephase to start at zero
-	time = lfo_cycle_remainder(freq, time);
-	return linear_interpolate(0.0, -1.0, period, 1.0, time);
+	phase += 0.5;               // dephase to start at zero
+	if (1.0 <= phase)
+		phase -= 1.0;
+	return linear_interpolate(0.0, -1.0, 1.0, 1.0, phase);
 }
 
-double Voice::lfo_square_pitch(double freq, double time)
+double Voice::lfo_square_pitch(double phase)
 {
-	time = lfo_cycle_remainder(freq, time);
-	double period = 1.0 /freq;
-	double half_period = period / 2.0;
-	if (time < half_period)
+	if (phase < 0.5)
 		return -1.0;
 	else
 		return 1.0;
 }
 
-double Voice::lfo_rand_pitch(double freq, double time)
+double Voice::lfo_rand_pitch(double phase, uint32_t cycle)
 {
-	double period = 1.0 /freq;
-	double half_period = period / 2.0;
-	uint32_t index = std::floor(time / half_period);
+	// New random value every half cycle
+	uint32_t index = 2 * cycle + (phase < 0.5 ? 0 : 1);
 	uint32_t rnd = hash(index);
 	static const uint32_t uint32_t_max = std::numeric_limits<uint32_t>::max();
 	return linear_interpolate(0, -1.0, uint32_t_max, 1.0, rnd);
@@ -28,6 +28,8 @@
 #include <cstdint>
 
 #include "patch.hpp"
+#include "chip.hpp"
+#include "curves.hpp"
 
 namespace zynayumi {
 
@@ -41,11 +43,18 @@ class Engine;
 class Voice {
 public:
 
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Number of segments of the LFO sine wavetable
+	static const int LFO_SINE_TABLE_SIZE = 1024;
+
 	/////////////////////////////////
 	// Constructors/descructors    //
 	/////////////////////////////////
 
-	Voice(Engine& engine, const Patch& patch, unsigned char ym_channel);
+	Voice(Engine& engine, const Patch& patch, Chip& chip, unsigned char ym_channel);
 	~Voice();
 
 	////////////////
@@ -61,8 +70,11 @@ public:
 	void enable();
 	void disable();
 	void silence();
+	void refresh();             // Re-apply all registers on next update
 	bool is_silent() const;
-	void update();              // Update the voice state
+	void update(int frame);     // Update the voice state, must be
+	                            // called once per sample, frame being
+	                            // its index in the rendered block
 
 	static double linear_interpolate(double x1, double y1,
 	                                 double x2, double y2,
@@ -81,7 +93,7 @@ public:
 	///////////////////
 
 	bool enabled;               // Whether the voice is enabled
-	int ym_channel;             // YM2149 channel
+	int ym_channel;             // YM2149 channel within its chip
 	unsigned char velocity;     // Note velocity
 	double velocity_level;      // Corresponding velocity level
 	unsigned char pitch;        // Note pitch
@@ -95,6 +107,7 @@ private:
 	// References are passed by pointer to please move assign operator
 	Engine* _engine;
 	const Patch* _patch;
+	Chip* _chip;                       // Chip of the YM channel
 
 	double _initial_pitch;             // Initial note pitch
 
@@ -113,12 +126,27 @@ private:
 
 	// Pitch envelope
 	double _relative_pitchenv_pitch;   // Relative pitch envelope pitch
+	LogisticCurve _pitchenv_curve;     // Pitch envelope curve
+	PitchEnv _pitchenv_params;         // Parameters of _pitchenv_curve
+	bool _pitchenv_dirty;              // Whether _pitchenv_curve must
+	                                   // be reconfigured
 
 	// Portamento
 	double _relative_port_pitch;       // Relative portamento pitch
+	LogisticCurve _port_curve;         // Portamento curve
+	double _port_pitch_diff;           // Parameters of _port_curve
+	double _port_end_time;
+	float _port_smoothness;
+	bool _port_dirty;                  // Whether _port_curve must be
+	                                   // reconfigured
 
 	// LFO
 	double _relative_lfo_pitch;        // Relative LFO pitch
+	double _lfo_phase;                 // LFO phase, within [0, 1)
+	uint32_t _lfo_cycle;               // Number of LFO cycles since
+	                                   // voice on
+	double _lfo_time;                  // Time of the last LFO phase
+	                                   // update
 
 	// Sequencer
 	int _seq_step;                     // Total number of steps since
@@ -170,14 +198,28 @@ private:
 	                                   // ringmod waveform segment
 	double _ringmod_whole_smp_period;  // Number of samples to make the
 	                                   // whole ringmod waveform
+	double _ringmod_depth;             // Ring modulation depth,
+	                                   // accounting for velocity and
+	                                   // sequencer
 
 	double _buzzer_pitch;              // Pitch of the buzzer
 	int _buzzer_period;                // Period of the buzzer
 
 	double _actual_sustain_level;
 
+	// Amplitude envelope
+	LinearSegments _env_segments;      // Envelope segments of the
+	                                   // current note on or off
+	Env _env_params;                   // Parameters of _env_segments
+	bool _env_dirty;                   // Whether _env_segments must be
+	                                   // rebuilt
+
 	bool _first_update;
 
+	unsigned _control_countdown;       // Number of samples before the
+	                                   // next control update. Null
+	                                   // means update on next sample.
+
 	bool _tone_trigger;                // True iff tone goes from 0 to 1
 	int _last_tone;
 
@@ -187,23 +229,33 @@ private:
 	 */
 	double ym_channel_to_spread() const;
 
-	void update_pan();
+	// Update modulators (envelopes, LFO, portamento, sequencer, etc),
+	// called every Engine::control_period samples.
+	void update_control(int frame);
+
+	// Update what must be processed every sample (ring modulation
+	// waveform stepping, sync and final level).
+	void update_audio();
+
+	void update_pan(int frame);
 	void update_seq();
 	void update_tone();
 	void update_tone_off();
 	void update_noise_off();
 	void update_noise_period();
 	void update_pitchenv();
-	void update_lfo();
+	void update_lfo(int frame);
 	void update_arp();
 	void update_portamento();
-	void update_final_pitch();
+	void update_final_pitch(int frame);
 	void update_env();
+	void update_env_segments();
 	void update_ringmod();
 	void update_ringmod_pitch();
 	void update_ringmod_smp_period();
 	void update_ringmod_smp_count();
 	void update_ringmod_waveform_index();
+	void update_ringmod_depth();
 	void update_ringmod_waveform_level();
 	void update_buzzer();
 	void update_buzzer_off();
@@ -223,13 +275,13 @@ private:
 	static double velocity_to_depth(double velocity_sensitivity,
 	                                unsigned char velocity);
 
-	static double lfo_cycle_remainder(double freq, double time);
-	static double lfo_sine_pitch(double freq, double time);
-	static double lfo_triangle_pitch(double freq, double time);
-	static double lfo_downsaw_pitch(double freq, double time);
-	static double lfo_upsaw_pitch(double freq, double time);
-	static double lfo_square_pitch(double freq, double time);
-	static double lfo_rand_pitch(double freq, double time);
+	// LFO shapes as functions of the phase, within [0, 1)
+	static double lfo_sine_pitch(double phase);
+	static double lfo_triangle_pitch(double phase);
+	static double lfo_downsaw_pitch(double phase);
+	static double lfo_upsaw_pitch(double phase);
+	static double lfo_square_pitch(double phase);
+	static double lfo_rand_pitch(double phase, uint32_t cycle);
 
 	// Map a seed x to a pseudo random number within uint32_t
 	static uint32_t hash(uint32_t x);
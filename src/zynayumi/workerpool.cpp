@@ -0,0 +1,153 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    workerpool.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "workerpool.hpp"
+
+using namespace zynayumi;
+
+WorkerPool::WorkerPool()
+	: _quit(false)
+	, _task(nullptr)
+	, _context(nullptr)
+	, _state(0)
+	, _pending(0)
+{
+	sem_init(&_wake, 0, 0);
+}
+
+WorkerPool::~WorkerPool()
+{
+	stop();
+	sem_destroy(&_wake);
+}
+
+namespace {
+
+// Hint the CPU that the calling thread is spinning
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield");
+#endif
+}
+
+} // ~namespace
+
+void WorkerPool::start(int count, const std::vector<int>& cpus)
+{
+	stop();
+	count = std::clamp(count, 0, MAX_WORKERS);
+	_quit = false;
+	_workers.reserve(count);
+	for (int i = 0; i < count; i++) {
+		_workers.emplace_back(&WorkerPool::work, this);
+#ifdef __linux__
+		if (cpus.empty() or cpus[i % cpus.size()] < 0
+		    or CPU_SETSIZE <= cpus[i % cpus.size()])
+			continue;
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(cpus[i % cpus.size()], &cpuset);
+		pthread_setaffinity_np(_workers.back().native_handle(),
+		                       sizeof(cpu_set_t), &cpuset);
+#endif
+	}
+}
+
+void WorkerPool::stop()
+{
+	_quit = true;
+	for (unsigned i = 0; i < _workers.size(); i++)
+		sem_post(&_wake);
+	for (std::thread& worker : _workers)
+		worker.join();
+	_workers.clear();
+}
+
+int WorkerPool::size() const
+{
+	return _workers.size();
+}
+
+void WorkerPool::run(Task task, void* context, int count)
+{
+	count = std::clamp(count, 0, MAX_TASKS);
+	if (count == 0)
+		return;
+
+	// Publish the job. Workers still running tasks of the previous one
+	// have all completed them, and workers waking up late only see
+	// the new generation.
+	_task = task;
+	_context = context;
+	_pending.store(count, std::memory_order_relaxed);
+	uint64_t generation = (_state.load(std::memory_order_relaxed) >> 48) + 1;
+	_state.store((generation << 48) | ((uint64_t)count << 32),
+	             std::memory_order_release);
+
+	// Wake up as many workers as needed, run tasks along them, then
+	// wait for the last ones to complete.
+	int wakes = std::min(count - 1, (int)_workers.size());
+	for (int i = 0; i < wakes; i++)
+		sem_post(&_wake);
+	run_tasks();
+	for (int spin = 0; _pending.load(std::memory_order_acquire) != 0; spin++) {
+		if (spin < SPIN_COUNT)
+			cpu_relax();
+		else
+			std::this_thread::yield();
+	}
+}
+
+void WorkerPool::work()
+{
+	for (;;) {
+		while (sem_wait(&_wake) != 0);
+		if (_quit)
+			return;
+		run_tasks();
+	}
+}
+
+void WorkerPool::run_tasks()
+{
+	for (;;) {
+		uint64_t state = _state.fetch_add(1, std::memory_order_acquire);
+		uint32_t index = state & 0xffffffff;
+		uint32_t count = (state >> 32) & 0xffff;
+		if (count <= index)
+			return;
+		_task(_context, index);
+		_pending.fetch_sub(1, std::memory_order_release);
+	}
+}
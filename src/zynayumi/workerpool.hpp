@@ -0,0 +1,123 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    workerpool.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_WORKERPOOL_HPP
+#define __ZYNAYUMI_WORKERPOOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <semaphore.h>
+
+namespace zynayumi {
+
+/**
+ * Pool of worker threads running the tasks of a job in parallel with
+ * the calling thread, meant to render chips from the audio thread.
+ *
+ * Threads are created by start and joined by stop, which are not
+ * real-time safe. Running a job is: it neither locks nor allocates.
+ * Tasks are handed off through a single atomic word holding the job
+ * generation, its number of tasks and the index of the next task to
+ * claim, workers being woken up by a semaphore. Workers are pinned to
+ * the CPUs given by the caller, if any and when the system allows it.
+ */
+class WorkerPool {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	static const int MAX_WORKERS = 16;
+
+	// Number of times the calling thread polls the completion of the
+	// tasks of the workers before yielding its time slice
+	static const int SPIN_COUNT = 4096;
+
+	// Maximum number of tasks per job
+	static const int MAX_TASKS = 0xffff;
+
+	// Task of a job, given its context and its index within [0, count)
+	typedef void (*Task)(void* context, int index);
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	WorkerPool();
+	~WorkerPool();
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	// Stop the current workers then start count of them, at most
+	// MAX_WORKERS. Worker i is pinned to CPU cpus[i % cpus.size()],
+	// which should not be the CPU of the calling thread of run. If
+	// cpus is empty, workers are left to the scheduler. Not real-time
+	// safe.
+	void start(int count, const std::vector<int>& cpus = {});
+
+	// Stop and join the workers. Not real-time safe.
+	void stop();
+
+	// Number of workers
+	int size() const;
+
+	// Run task over indices [0, count), count being at most MAX_TASKS,
+	// on the workers and the calling thread, and return once they are
+	// all done. Real-time safe. Must not be called concurrently.
+	void run(Task task, void* context, int count);
+
+private:
+	// Wait for jobs and run their tasks until stopped
+	void work();
+
+	// Claim and run the tasks of the current job until none is left
+	void run_tasks();
+
+	std::vector<std::thread> _workers;
+
+	// Posted once per worker to wake up for a job or to quit
+	sem_t _wake;
+	std::atomic<bool> _quit;
+
+	// Current job
+	Task _task;
+	void* _context;
+
+	// Job state: generation in bits 48 to 63, task count in bits 32 to
+	// 47, index of the next task to claim in bits 0 to 31
+	std::atomic<uint64_t> _state;
+
+	// Number of tasks of the current job not completed yet
+	std::atomic<int> _pending;
+};
+
+} // ~namespace zynayumi
+
+#endif
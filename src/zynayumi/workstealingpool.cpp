@@ -0,0 +1,113 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    workstealingpool.cpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "workstealingpool.hpp"
+
+using namespace zynayumi;
+
+namespace {
+
+// Queue of task indices of a thread
+struct TaskQueue {
+	std::mutex mutex;
+	std::deque<size_t> tasks;
+};
+
+} // ~namespace
+
+WorkStealingPool::WorkStealingPool(int thread_count)
+	: _thread_count(thread_count)
+	, _steal_count(0)
+{
+	if (_thread_count <= 0)
+		_thread_count = std::max(1u, std::thread::hardware_concurrency());
+}
+
+int WorkStealingPool::get_thread_count() const
+{
+	return _thread_count;
+}
+
+void WorkStealingPool::run(size_t count, const Task& task)
+{
+	const int thread_count = std::max<int>(1, std::min<size_t>(_thread_count, count));
+
+	// Split the tasks in contiguous ranges
+	std::unique_ptr<TaskQueue[]> queues(new TaskQueue[thread_count]);
+	for (int t = 0; t < thread_count; t++)
+		for (size_t i = count * t / thread_count; i < count * (t + 1) / thread_count; i++)
+			queues[t].tasks.push_back(i);
+
+	// No task is added during the run, so once all queues are empty
+	// there is nothing left to run or steal.
+	std::atomic<size_t> steal_count(0);
+	auto work = [&](int t) {
+		for (;;) {
+			size_t index;
+			bool found = false;
+			{
+				std::lock_guard<std::mutex> lock(queues[t].mutex);
+				if (not queues[t].tasks.empty()) {
+					index = queues[t].tasks.back();
+					queues[t].tasks.pop_back();
+					found = true;
+				}
+			}
+			for (int v = 1; v < thread_count and not found; v++) {
+				TaskQueue& victim = queues[(t + v) % thread_count];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (not victim.tasks.empty()) {
+					index = victim.tasks.front();
+					victim.tasks.pop_front();
+					found = true;
+					steal_count++;
+				}
+			}
+			if (not found)
+				return;
+			task(index, t);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 1; t < thread_count; t++)
+		threads.emplace_back(work, t);
+	work(0);
+	for (std::thread& thread : threads)
+		thread.join();
+	_steal_count = steal_count;
+}
+
+size_t WorkStealingPool::get_steal_count() const
+{
+	return _steal_count;
+}
@@ -0,0 +1,76 @@
+/****************************************************************************
+
+    Zynayumi Synth based on ayumi, a highly precise emulation of the YM2149
+
+    workstealingpool.hpp
+
+    Copyleft (c) 2026 Nil Geisweiller
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 01222-1307  USA
+
+****************************************************************************/
+
+#ifndef __ZYNAYUMI_WORKSTEALINGPOOL_HPP
+#define __ZYNAYUMI_WORKSTEALINGPOOL_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace zynayumi {
+
+/**
+ * Work stealing thread pool running a batch of independent, possibly
+ * long and uneven, tasks, such as offline renders.
+ *
+ * Tasks are initially split in contiguous ranges, one per thread.
+ * Each thread runs its own tasks from the back of its queue, and once
+ * done steals tasks from the front of the queues of the others. Not
+ * real-time safe, see WorkerPool for the real-time counterpart.
+ */
+class WorkStealingPool {
+public:
+
+	// Task given its index within [0, count) and the index of the
+	// thread running it within [0, thread_count)
+	typedef std::function<void(size_t index, int thread)> Task;
+
+	/////////////////////////////////
+	// Constructors/descructors    //
+	/////////////////////////////////
+
+	// Use thread_count threads, including the calling one, all cores
+	// if null.
+	WorkStealingPool(int thread_count = 0);
+
+	////////////////
+	// Methods    //
+	////////////////
+
+	int get_thread_count() const;
+
+	// Run task over indices [0, count) and return once all are done
+	void run(size_t count, const Task& task);
+
+	// Number of tasks stolen during the last run
+	size_t get_steal_count() const;
+
+private:
+	int _thread_count;
+	size_t _steal_count;
+};
+
+} // ~namespace zynayumi
+
+#endif
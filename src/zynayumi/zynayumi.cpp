@@ -22,9 +22,10 @@
 
 ****************************************************************************/
 
+#include <algorithm>
 #include <cstdio>
-#include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "zynayumi.hpp"
 
@@ -54,10 +55,104 @@ double Zynayumi::get_bpm() const
 	return engine.bpm;
 }
 
-void Zynayumi::audio_process(float* left_out, float* right_out,
+void Zynayumi::set_worker_count(int count, const std::vector<int>& cpus)
+{
+	engine.set_worker_count(count, cpus);
+}
+
+int Zynayumi::get_worker_count() const
+{
+	return engine.get_worker_count();
+}
+
+bool Zynayumi::audio_process(float* left_out, float* right_out,
                              unsigned long sample_count)
 {
-	engine.audio_process(left_out, right_out, sample_count);
+	return audio_process(left_out, right_out, sample_count, nullptr, 0);
+}
+
+bool Zynayumi::audio_process(float* left_out, float* right_out,
+                             unsigned long sample_count,
+                             const MidiEvent* events, unsigned event_count)
+{
+	bool silent = true;
+	unsigned long frame = 0;
+
+	// Only the changes posted so far are applied, so that a busy
+	// control thread cannot hold the audio thread
+	unsigned change_count = parameter_queue.size();
+	ParameterChange change;
+	bool has_change = 0 < change_count and parameter_queue.pop(change);
+
+	unsigned i = 0;
+	while (i < event_count or has_change) {
+		// Take the earliest of the next change and the next event
+		bool is_change = has_change and (i == event_count
+		                                 or change.frame <= events[i].frame);
+		unsigned long next_frame = is_change ? change.frame : events[i].frame;
+
+		// Render up to it. Unsorted events are processed at the
+		// current frame rather than going back in time.
+		unsigned long ev_frame = std::min(std::max(next_frame, frame),
+		                                  sample_count);
+		if (frame < ev_frame) {
+			silent = engine.audio_process(left_out + frame, right_out + frame,
+			                              ev_frame - frame) and silent;
+			frame = ev_frame;
+		}
+
+		if (is_change) {
+			change.apply();
+			has_change = 0 < --change_count and parameter_queue.pop(change);
+		} else {
+			raw_event_process(events[i].size, events[i].data);
+			i++;
+		}
+	}
+
+	// Render the remainder of the block
+	if (frame < sample_count)
+		silent = engine.audio_process(left_out + frame, right_out + frame,
+		                              sample_count - frame) and silent;
+	return silent;
+}
+
+bool Zynayumi::render_offline(const Patch& pa,
+                              const MidiEvent* events, unsigned event_count,
+                              unsigned long frame_count, PcmSink& sink)
+{
+	// Load the patch, including the YM channels it enables
+	patch = pa;
+	for (unsigned char c = 0; c < Chip::CHANNEL_COUNT; c++) {
+		if (patch.mixer.enabled[c])
+			engine.enable_ym_channel(c);
+		else
+			engine.disable_ym_channel(c);
+	}
+
+	std::vector<float> left(OFFLINE_BLOCK_SIZE), right(OFFLINE_BLOCK_SIZE);
+	std::vector<unsigned char> pcm(OFFLINE_BLOCK_SIZE * 2
+	                               * sample_size(sink.get_format()));
+	std::vector<MidiEvent> block_events;
+	unsigned e = 0;
+	for (unsigned long f = 0; f < frame_count; f += OFFLINE_BLOCK_SIZE) {
+		unsigned long size = std::min(OFFLINE_BLOCK_SIZE, frame_count - f);
+
+		// Gather the events of that block, relative to its start
+		block_events.clear();
+		for (; e < event_count and events[e].frame < f + size; e++) {
+			block_events.push_back(events[e]);
+			block_events.back().frame -= std::min(f, events[e].frame);
+		}
+
+		audio_process(left.data(), right.data(), size,
+		              block_events.data(), block_events.size());
+		PcmSink::interleave(left.data(), right.data(), size,
+		                    sink.get_format(), pcm.data());
+		if (not sink.write(pcm.data(), size))
+			return false;
+	}
+	return true;
 }
 
 void Zynayumi::raw_event_process(unsigned size,
@@ -116,15 +211,14 @@ void Zynayumi::midi_event_process(unsigned char status,
 			all_notes_off_process();
 			break;
 		default:
-			std::cerr << "Control change " << (int)cc << " unsupported" << std::endl;
+			engine.diagnostics.push(Diagnostics::Code::UnsupportedControlChange,
+			                        cc, value);
 		}
 		break;
 	}
 	default:
-		std::cerr << "Midi event (status=" << (int)status
-		          << ", byte1=" << (int)byte1
-		          << ", byte2=" << (int)byte2
-		          << ") not implemented" << std::endl;
+		engine.diagnostics.push(Diagnostics::Code::UnsupportedMidiEvent,
+		                        status, byte1, byte2);
 	}
 }
 
@@ -27,6 +27,8 @@
 
 #include "patch.hpp"
 #include "engine.hpp"
+#include "pcmsink.hpp"
+#include "parameterqueue.hpp"
 
 // Set 1 if you want to print debug messages, 0 otherwise
 #define ENABLE_PRINT_DEBUG 0
@@ -39,20 +41,40 @@
 
 namespace zynayumi {
 
+/**
+ * MIDI event stamped with its frame offset within the audio block it
+ * belongs to.
+ */
+struct MidiEvent {
+	unsigned long frame;        // Frame offset within the block
+	unsigned size;              // Number of bytes of data
+	unsigned char data[3];      // Raw MIDI bytes
+};
+
 class Zynayumi {
+public:
+
+	/////////////////
+	// Constants   //
+	/////////////////
+
+	// Number of frames rendered at once by render_offline
+	static const unsigned long OFFLINE_BLOCK_SIZE = 4096;
 
 	///////////////////
 	// Attributes    //
 	///////////////////
 
-public:
-
 	// Current patch
 	Patch patch;
 
 	// Engine of the Zynayumi
 	Engine engine;
 
+	// Parameter changes posted by a control thread, see
+	// Parameters::post_value, applied by audio_process at their frame
+	ParameterQueue parameter_queue;
+
 	/////////////////////////////////
 	// Constructors/descructors    //
 	/////////////////////////////////
@@ -72,16 +94,47 @@ public:
 	void set_bpm(double bpm);
 	double get_bpm() const;
 
-	// Process audio.
+	// Set/get the number of worker threads rendering chips in
+	// parallel, see Engine::set_worker_count
+	void set_worker_count(int count, const std::vector<int>& cpus = {});
+	int get_worker_count() const;
+
+	// Process audio. Return true iff the output is silent, see
+	// Engine::audio_process.
 	//
 	// Assumptions:
 	//
-	// 1. The parameters do not change during audio processing
+	// 1. During audio processing the parameters only change through
+	//    parameter_queue, whose changes are applied in frame order at
+	//    their frame within the block. Setting a value directly, with
+	//    Parameters::set_value for instance, from another thread is
+	//    not supported.
 	//
 	// 2. All processing is added to the buffers
-	void audio_process(float* left_out, float* right_out,
+	bool audio_process(float* left_out, float* right_out,
 	                   unsigned long sample_count);
 
+	// Process audio and MIDI events with sample accuracy.
+	//
+	// Events must be sorted by frame. Rendering is split at each
+	// event frame so that the event takes effect exactly at that
+	// sample. Events with a frame beyond sample_count are processed at
+	// the end of the block. The changes waiting in parameter_queue
+	// are applied the same way, before the events of the same frame.
+	// Same assumptions and return value as above apply.
+	bool audio_process(float* left_out, float* right_out,
+	                   unsigned long sample_count,
+	                   const MidiEvent* events, unsigned event_count);
+
+	// Render frame_count frames with patch and the events, whose
+	// frames are absolute and sorted, and stream them to sink by
+	// blocks of OFFLINE_BLOCK_SIZE frames. The engine settings
+	// (sample rate, oversampling, chip count, etc) are used as is. Not
+	// real-time safe. Return false if the sink fails.
+	bool render_offline(const Patch& patch,
+	                    const MidiEvent* events, unsigned event_count,
+	                    unsigned long frame_count, PcmSink& sink);
+
 	// Process MIDI events
 	void raw_event_process(unsigned size, const unsigned char* data);
 	void midi_event_process(unsigned char status,